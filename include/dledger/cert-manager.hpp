@@ -9,6 +9,7 @@
 #include <ndn-cxx/security/certificate.hpp>
 #include <ndn-cxx/interest.hpp>
 #include "record.hpp"
+#include <vector>
 
 using namespace ndn;
 namespace dledger {
@@ -24,6 +25,21 @@ namespace dledger {
          */
         virtual bool verifySignature(const Data &data) const = 0;
 
+        /**
+         * Verify the signatures of several data at once, e.g., a burst of records from a few producers,
+         * with the same rule as verifySignature(const Data&).
+         * The default implementation verifies them one by one.
+         * @param records the data to be check
+         * @return whether each signature is valid, in the order of the records
+         */
+        virtual std::vector<bool> verifySignatures(const std::vector<shared_ptr<const Data>> &records) const {
+            std::vector<bool> results;
+            for (const auto &data : records) {
+                results.push_back(verifySignature(*data));
+            }
+            return results;
+        }
+
         /**
          * Verify if the certificate or revocation record
          * has correct format
@@ -56,6 +56,72 @@ public:
    */
   time::milliseconds ancestorFetchTimeout = time::milliseconds(10000);
 
+  /**
+   * The maximum number of record fetching Interests outstanding at the same time.
+   */
+  size_t fetchWindowSize = 32;
+
+  /**
+   * The number of retransmissions of a record fetching Interest after a timeout or Nack.
+   */
+  size_t fetchRetryLimit = 3;
+
+  /**
+   * The delay before the first retransmission of a record fetching Interest; doubled for each further one.
+   */
+  time::milliseconds fetchRetryBackoff = time::milliseconds(250);
+
+  /**
+   * The number of threads verifying the signatures of fetched records; 0 verifies them on the Face thread.
+   * With threads, the certificate manager is called from them and must be thread-safe, as the default one is.
+   */
+  size_t verificationThreads = 0;
+
+  /**
+   * The number of decoded records kept in memory for the records read from the database.
+   */
+  size_t recordCacheCapacity = 1024;
+
+  /**
+   * The number of accepted records written to the database in one batch.
+   */
+  size_t backendWriteBatchSize = 64;
+
+  /**
+   * The maximum delay before the accepted records are written to the database.
+   */
+  time::milliseconds backendFlushInterval = time::milliseconds(100);
+
+  /**
+   * The maximum number of tailing record digests carried by one sync Interest.
+   */
+  size_t maxSyncDigests = 64;
+
+  /**
+   * The depth of the ancestors requested in one batch from a record producer; 0 disables batch fetching.
+   */
+  size_t batchFetchDepth = 16;
+
+  /**
+   * The maximum number of batches being fetched at a time.
+   */
+  size_t maxPendingBatches = 4;
+
+  /**
+   * The time span of a bucket used to compare records with other peers; must be the same on all peers.
+   */
+  time::milliseconds reconcileBucketWidth = time::milliseconds(60000);
+
+  /**
+   * The number of the latest buckets whose summaries are kept in memory and served to other peers.
+   */
+  size_t maxReconcileBuckets = 64;
+
+  /**
+   * The minimum interval between two reconciliations with other peers.
+   */
+  time::milliseconds reconcileInterval = time::milliseconds(30000);
+
   /**
    * The maximum clock skew allowed for other peer.
    */
@@ -77,6 +143,10 @@ public:
    * The path to the Database;
    */
    std::string databasePath;
+  /**
+   * The storage engine of the database: "leveldb", or "log" for the append-only segment log.
+   */
+  std::string storageEngine = "leveldb";
    /**
     * The Certificate manager
     */
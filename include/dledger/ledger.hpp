@@ -56,6 +56,45 @@ public:
   virtual std::list<Name>
   listRecord(const std::string& prefix) const = 0;
 
+  /**
+   * List a page of the records under a prefix, in storage order, without building the whole list in memory.
+   * @p prefix, input, an NDN name prefix
+   * @p pageSize, input, the maximum number of records in the page
+   * @p cursor, input/output, an opaque resume token; empty for the first page,
+   *    set to the token of the next page, or to empty after the last page
+   */
+  virtual std::list<Name>
+  listRecord(const std::string& prefix, size_t pageSize, std::string& cursor) const = 0;
+
+  /**
+   * List the records of a type generated in a time range, in generation order.
+   * @p type, input, the record type
+   * @p since, input, the start of the time range, inclusive
+   * @p until, input, the end of the time range, exclusive
+   */
+  virtual std::list<Name>
+  listRecordByType(RecordType type, const time::system_clock::TimePoint& since,
+                   const time::system_clock::TimePoint& until = time::system_clock::TimePoint::max()) const = 0;
+
+  /**
+   * List the records of a producer generated in a time range, in generation order.
+   * @p producerPrefix, input, the NDN name of the producer
+   * @p since, input, the start of the time range, inclusive
+   * @p until, input, the end of the time range, exclusive
+   */
+  virtual std::list<Name>
+  listRecordByProducer(const std::string& producerPrefix, const time::system_clock::TimePoint& since,
+                       const time::system_clock::TimePoint& until = time::system_clock::TimePoint::max()) const = 0;
+
+  /**
+   * List the records generated in a time range, in generation order.
+   * @p since, input, the start of the time range, inclusive
+   * @p until, input, the end of the time range, exclusive
+   */
+  virtual std::list<Name>
+  listRecordByTime(const time::system_clock::TimePoint& since,
+                   const time::system_clock::TimePoint& until = time::system_clock::TimePoint::max()) const = 0;
+
   /**
    * Set additional checking rules when receiving a new record.
    * @p onRecordAppCheck, input, a callback function invoked whenever there is a new record received from the Internet.
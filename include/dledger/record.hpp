@@ -6,6 +6,7 @@
 #include <list>
 #include <ndn-cxx/data.hpp>
 #include <ndn-cxx/security/certificate.hpp>
+#include <boost/container/small_vector.hpp>
 
 using namespace ndn;
 namespace dledger {
@@ -18,6 +19,78 @@ enum RecordType {
   GENESIS_RECORD = 4,
 };
 
+/**
+ * A read-only view of contiguous elements kept by a record.
+ * The view is valid as long as the record it comes from is alive and not modified.
+ */
+template<typename T>
+class RecordSpan
+{
+public:
+  using value_type = T;
+  using const_iterator = const T*;
+  using iterator = const_iterator;
+
+  RecordSpan() = default;
+
+  RecordSpan(const T* data, size_t size)
+      : m_data(data), m_size(size)
+  {
+  }
+
+  template<typename Container>
+  RecordSpan(const Container& container)
+      : m_data(container.data()), m_size(container.size())
+  {
+  }
+
+  const_iterator
+  begin() const {
+    return m_data;
+  }
+
+  const_iterator
+  end() const {
+    return m_data + m_size;
+  }
+
+  size_t
+  size() const {
+    return m_size;
+  }
+
+  bool
+  empty() const {
+    return m_size == 0;
+  }
+
+  const T&
+  operator[](size_t i) const {
+    return m_data[i];
+  }
+
+  const T&
+  front() const {
+    return m_data[0];
+  }
+
+  const T&
+  back() const {
+    return m_data[m_size - 1];
+  }
+
+private:
+  const T* m_data = nullptr;
+  size_t m_size = 0;
+};
+
+/**
+ * The inline storage of the record elements; a record usually carries a couple of pointers
+ * (Config::precedingRecordNum) and items, which then need no allocation of their own.
+ */
+template<typename T, size_t N = 2>
+using RecordElements = boost::container::small_vector<T, N>;
+
 /**
  * The record.
  * Record Name: /<application-common-prefix>/<producer-name>/<record-type>/<record-identifier>/<timestamp>
@@ -50,8 +123,11 @@ public: // used for preparing a new record before appending it into the DLedger
    *       This cannot be used when a record has not been appended into the ledger
    * @p recordItem, input, the record payload to add.
    */
-  Name
-  getRecordName() const;
+  const Name&
+  getRecordName() const
+  {
+    return m_recordName;
+  }
 
   /**
    * Get the record type of the record.
@@ -72,7 +148,7 @@ public: // used for preparing a new record before appending it into the DLedger
   /**
    * Get record payload items.
    */
-  const std::list<Block>&
+  RecordSpan<Block>
   getRecordItems() const;
 
   /**
@@ -85,7 +161,7 @@ public: // used for generating a new record before appending it into the DLedger
   /**
    * @note This constructor is supposed to be used by the LedgerImpl class only
    */
-  Record(const std::shared_ptr<Data>& data);
+  Record(const std::shared_ptr<const Data>& data);
 
   /**
    * @note This constructor is supposed to be used by the LedgerImpl class only
@@ -96,7 +172,7 @@ public: // used for generating a new record before appending it into the DLedger
    * Get the pointers from the header.
    * @note This function is supposed to be used by the DLedger class only
    */
-  const std::list<Name>&
+  RecordSpan<Name>
   getPointersFromHeader() const;
 
   /**
@@ -114,31 +190,60 @@ public: // used for generating a new record before appending it into the DLedger
   void
   checkPointerCount(int numPointers) const;
 
+  /**
+   * Prepend the record header and body to the encoder.
+   * @return the number of bytes prepended
+   */
+  template<encoding::Tag TAG>
+  size_t
+  wireEncode(EncodingImpl<TAG>& encoder) const;
+
+  /**
+   * Encode the record header and body into a Data Content block.
+   * The size is estimated first, so the record is written into one buffer of the exact size.
+   */
+  Block
+  wireEncode() const;
+
   /**
    * Encode the record header and body into the block.
    * @p block, output, the Data Content block to carry the encoded record.
+   * @deprecated Use wireEncode(), which returns the Content block.
    */
+  [[deprecated("use Block Record::wireEncode()")]]
   void
   wireEncode(Block& block) const;
 
-  Name
-  getProducerPrefix() const;
+  const Name&
+  getProducerPrefix() const
+  {
+    return m_producerPrefix;
+  }
 
   time::system_clock::TimePoint
-  getGenerationTimestamp() const;
+  getGenerationTimestamp() const
+  {
+    return m_generationTimestamp;
+  }
 
   /**
-   * Data packet with name
+   * Get the Data packet with name
    * /<application-common-prefix>/<producer-name>/<record-type>/<record-name>/<timestamp>
+   * or nullptr if the record has not been appended into the DLedger.
    */
-  std::shared_ptr<const Data> m_data;
+  const std::shared_ptr<const Data>&
+  getData() const
+  {
+    return m_data;
+  }
 
 private:
+  /**
+   * Set the Data packet of the record and decode its name once into the cached name fields.
+   * @note This function is supposed to be used by the DLedger class only
+   */
   void
-  headerWireEncode(Block& block) const;
-
-  void
-  bodyWireEncode(Block& block) const;
+  setData(const std::shared_ptr<const Data>& data);
 
   void
   headerWireDecode(const Block& dataContent);
@@ -167,16 +272,26 @@ private:
    * /<application-common-prefix>/<producer-name>/<record-type>/<record-name>/<timestamp>
    */
   std::string m_uniqueIdentifier;
+  /**
+   * The fields decoded from the Data name, so that the accessors do not parse the name again.
+   */
+  Name m_recordName; // full name, with the implicit digest
+  Name m_producerPrefix;
+  time::system_clock::TimePoint m_generationTimestamp;
+  /**
+   * The Data packet of the record, only set through setData() so that the cached name fields match it.
+   */
+  std::shared_ptr<const Data> m_data;
 
 protected:
   /**
    * The list of pointers to preceding records.
    */
-  std::list<Name> m_recordPointers;
+  RecordElements<Name> m_recordPointers;
   /**
    * The data structure to carry the record body payloads.
    */
-  std::list<Block> m_contentItems;
+  RecordElements<Block> m_contentItems;
 
   friend class LedgerImpl;
 };
@@ -202,18 +317,18 @@ public:
   void
   addCertificateItem(const security::Certificate& certificate);
 
-  const std::list<security::Certificate> &
+  RecordSpan<security::Certificate>
   getCertificates() const;
 
   void
   addPrevCertPointer(const Name& recordName);
 
-  const std::list<Name> &
+  RecordSpan<Name>
   getPrevCertificates() const;
 
 private:
-  std::list<security::Certificate> m_cert_list;
-  std::list<Name> m_prev_cert;
+  RecordElements<security::Certificate, 1> m_cert_list;
+  RecordElements<Name, 1> m_prev_cert;
 };
 
 class RevocationRecord : public Record {
@@ -231,11 +346,11 @@ public:
     void
     addCertificateNameItem(const Name &certificateName);
 
-    const std::list<Name> &
+    RecordSpan<Name>
     getRevokedCertificates() const;
 
 private:
-    std::list<Name> m_revoked_cert_list;
+    RecordElements<Name, 1> m_revoked_cert_list;
 };
 
 class GenesisRecord : public Record {
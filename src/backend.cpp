@@ -1,80 +1,353 @@
 #include "backend.hpp"
+#include "record_name.hpp"
 
-#include <cassert>
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+#include <algorithm>
 #include <iostream>
 
 namespace dledger {
 
-Backend::Backend(const std::string& dbDir)
+// index keys start with a zero byte, which is not a valid TLV type of a name component
+const std::string Backend::RECORD_KEYS_BEGIN("\x01", 1);
+const std::string Backend::INDEXED_KEY("\0indexed", 8);
+const std::string Backend::TIME_INDEX("\0t", 2);
+const std::string Backend::TYPE_INDEX("\0y", 2);
+const std::string Backend::PRODUCER_INDEX("\0p", 2);
+
+static std::string
+encodeTimestamp(const time::system_clock::TimePoint& timestamp)
 {
-    leveldb::Options options;
-    options.create_if_missing = true;
-    leveldb::Status status = leveldb::DB::Open(options, dbDir, &m_db);
-    if (!status.ok()) {
-        std::cerr << "Unable to open/create database " << dbDir << std::endl;
-        std::cerr << status.ToString() << std::endl;
-        BOOST_THROW_EXCEPTION(std::runtime_error("Unable to open/create database"));
-    }
+  // big endian, so that the keys sort by time
+  auto count = time::duration_cast<time::milliseconds>(timestamp.time_since_epoch()).count();
+  uint64_t value = count < 0 ? 0 : static_cast<uint64_t>(count);
+  std::string bytes(sizeof(value), '\0');
+  for (size_t i = 0; i < sizeof(value); i++) {
+    bytes[sizeof(value) - 1 - i] = static_cast<char>(value >> (8 * i));
+  }
+  return bytes;
+}
+
+Backend::Backend(const std::string& dbDir, size_t maxPendingWrites, const std::string& engineType)
+    : m_engine(StorageEngine::create(engineType, dbDir))
+    , m_maxPendingWrites(maxPendingWrites)
+{
+  if (m_engine->get(INDEXED_KEY) == nullptr) {
+    buildIndexes();
+  }
+  rebuildFilter();
 }
 
 Backend::~Backend()
 {
-  delete m_db;
+  flush();
+}
+
+std::string
+Backend::makeKey(const Name& recordName)
+{
+  // the components without the outer Name TLV: a name prefix is a byte prefix of the key
+  const auto& wire = recordName.wireEncode();
+  return std::string(reinterpret_cast<const char*>(wire.value()), wire.value_size());
+}
+
+Name
+Backend::keyToName(const std::string& key)
+{
+  return Name(makeBinaryBlock(tlv::Name, reinterpret_cast<const uint8_t*>(key.data()), key.size()));
+}
+
+std::string
+Backend::getPrefixEnd(const std::string& prefix)
+{
+  std::string end = prefix;
+  while (!end.empty() && static_cast<uint8_t>(end.back()) == 0xFF) {
+    end.pop_back();
+  }
+  if (!end.empty()) {
+    end.back() = static_cast<char>(static_cast<uint8_t>(end.back()) + 1);
+  }
+  return end;
+}
+
+std::vector<std::string>
+Backend::makeIndexKeys(const Name& recordName, const std::string& recordKey)
+{
+  std::vector<std::string> keys;
+  try {
+    RecordName name(recordName);
+    auto timestamp = encodeTimestamp(name.getGenerationTimestamp());
+    const auto& producer = name.getProducerPrefix().wireEncode();
+    // the producer keeps its outer TLV so that one producer prefix is not a prefix of another's key
+    std::string producerKey(reinterpret_cast<const char*>(producer.wire()), producer.size());
+    keys.push_back(TIME_INDEX + timestamp + recordKey);
+    keys.push_back(TYPE_INDEX + static_cast<char>(name.getRecordType()) + timestamp + recordKey);
+    keys.push_back(PRODUCER_INDEX + producerKey + timestamp + recordKey);
+  } catch (const std::exception& e) {
+    // not a record name, e.g., data stored directly by tests
+  }
+  return keys;
+}
+
+void
+Backend::buildIndexes()
+{
+  static const uint8_t EMPTY_VALUE = 0;
+  std::vector<StorageEngine::Write> writes;
+  for (const auto& key : m_engine->listKeys(RECORD_KEYS_BEGIN, "")) {
+    for (auto& indexKey : makeIndexKeys(keyToName(key), key)) {
+      writes.push_back({std::move(indexKey), &EMPTY_VALUE, 0});
+    }
+  }
+  writes.push_back({INDEXED_KEY, &EMPTY_VALUE, 0});
+  if (!m_engine->write(writes)) {
+    BOOST_THROW_EXCEPTION(std::runtime_error("Unable to index database"));
+  }
+}
+
+uint64_t
+Backend::hashKey(const std::string& key)
+{
+  return std::hash<std::string>()(key);
+}
+
+void
+Backend::rebuildFilter()
+{
+  std::vector<uint64_t> hashes;
+  // only the record keys; the index keys sort before them
+  for (const auto& key : listKeys(RECORD_KEYS_BEGIN, "")) {
+    hashes.push_back(hashKey(key));
+  }
+  m_filter = BloomFilter(std::max<size_t>(1024, hashes.size() * 2));
+  for (auto hash : hashes) {
+    m_filter.insert(hash);
+  }
 }
 
 shared_ptr<Data>
 Backend::getRecord(const Name& recordName) const
 {
-  const auto& nameStr = recordName.toUri();
-  leveldb::Slice key = nameStr;
-  std::string value;
-  leveldb::Status s = m_db->Get(leveldb::ReadOptions(), key, &value);
-  if (!s.ok()) {
+  const auto& keyStr = makeKey(recordName);
+  if (!m_filter.mayContain(hashKey(keyStr))) {
     return nullptr;
   }
-  else {
-    ndn::Block block((const uint8_t*)value.c_str(), value.size());
-    return make_shared<Data>(block);
+  auto pending = m_pendingWrites.find(keyStr);
+  if (pending != m_pendingWrites.end()) {
+    return pending->second.isDeleted ? nullptr : make_shared<Data>(*pending->second.record);
   }
+  auto value = m_engine->get(keyStr);
+  if (value == nullptr) {
+    return nullptr;
+  }
+  // the Block and the Data share the buffer read by the engine
+  return make_shared<Data>(Block(value));
 }
 
 bool
 Backend::putRecord(const shared_ptr<const Data>& recordData)
 {
-  const auto& nameStr = recordData->getFullName().toUri();
-  leveldb::Slice key = nameStr;
-  auto recordBytes = recordData->wireEncode();
-  leveldb::Slice value((const char*)recordBytes.wire(), recordBytes.size());
-  leveldb::Status s = m_db->Put(leveldb::WriteOptions(), key, value);
-  if (!s.ok()) {
+  const auto& fullName = recordData->getFullName();
+  const auto& keyStr = makeKey(fullName);
+  recordData->wireEncode();
+  m_pendingWrites[keyStr] = PendingWrite{false, recordData};
+  for (const auto& indexKey : makeIndexKeys(fullName, keyStr)) {
+    m_pendingWrites[indexKey] = PendingWrite{false, nullptr};
+  }
+  m_pendingRecordCount++;
+  m_filter.insert(hashKey(keyStr));
+  if (m_filter.size() > m_filter.getCapacity()) {
+    rebuildFilter();
+  }
+  if (m_pendingRecordCount >= m_maxPendingWrites) {
+    return flush();
+  }
+  return true;
+}
+
+bool
+Backend::flush()
+{
+  static const uint8_t EMPTY_VALUE = 0;
+  if (m_pendingWrites.empty()) {
+    return true;
+  }
+  std::vector<StorageEngine::Write> writes;
+  for (const auto& pending : m_pendingWrites) {
+    if (pending.second.isDeleted) {
+      writes.push_back({pending.first, nullptr, 0});
+    }
+    else if (pending.second.record != nullptr) {
+      const auto& recordBytes = pending.second.record->wireEncode();
+      writes.push_back({pending.first, recordBytes.wire(), recordBytes.size()});
+    }
+    else {
+      writes.push_back({pending.first, &EMPTY_VALUE, 0});
+    }
+  }
+  if (!m_engine->write(writes)) {
+    // keep the writes visible and pending, so that the next flush retries them
+    std::cerr << "Unable to write " << writes.size() << " pending keys to database" << std::endl;
     return false;
   }
+  m_pendingWrites.clear();
+  m_pendingRecordCount = 0;
   return true;
 }
 
 void
 Backend::deleteRecord(const Name& recordName)
 {
-  const auto& nameStr = recordName.toUri();
-  leveldb::Slice key = nameStr;
-  leveldb::Status s = m_db->Delete(leveldb::WriteOptions(), key);
-  if (!s.ok()) {
-    std::cerr << "Unable to delete value from database, key: " << nameStr << std::endl;
-    std::cerr << s.ToString() << std::endl;
+  const auto& keyStr = makeKey(recordName);
+  m_pendingWrites[keyStr] = PendingWrite{true, nullptr};
+  for (const auto& indexKey : makeIndexKeys(recordName, keyStr)) {
+    m_pendingWrites[indexKey] = PendingWrite{true, nullptr};
+  }
+  m_pendingRecordCount++;
+  if (m_pendingRecordCount >= m_maxPendingWrites && !flush()) {
+    std::cerr << "Unable to delete value from database, key: " << recordName << std::endl;
+  }
+}
+
+std::vector<std::string>
+Backend::listKeys(const std::string& begin, const std::string& end, size_t limit) const
+{
+  std::vector<std::string> keys;
+  // a cursor may be past the end of the range
+  if (limit == 0 || (!end.empty() && begin >= end)) {
+    return keys;
+  }
+  auto pending = m_pendingWrites.lower_bound(begin);
+  auto pendingEnd = end.empty() ? m_pendingWrites.end() : m_pendingWrites.lower_bound(end);
+  // pending deletions may hide stored keys, so read as many more
+  size_t storedLimit = limit;
+  for (auto it = pending; it != pendingEnd && storedLimit != std::numeric_limits<size_t>::max(); ++it) {
+    if (it->second.isDeleted) storedLimit++;
+  }
+  auto storedKeys = m_engine->listKeys(begin, end, storedLimit);
+  if (storedKeys.size() == storedLimit) {
+    // the stored keys after the last one read are unknown; so are the pending writes among them
+    pendingEnd = m_pendingWrites.upper_bound(storedKeys.back());
+  }
+  for (const auto& key : storedKeys) {
+    // merge the pending writes, which are in the same key order
+    bool isDeleted = false;
+    for (; pending != pendingEnd && pending->first <= key; ++pending) {
+      if (pending->first == key) {
+        isDeleted = pending->second.isDeleted;
+      }
+      else if (!pending->second.isDeleted) {
+        keys.push_back(pending->first);
+      }
+    }
+    if (!isDeleted) {
+      keys.push_back(key);
+    }
   }
+  for (; pending != pendingEnd; ++pending) {
+    if (!pending->second.isDeleted) {
+      keys.push_back(pending->first);
+    }
+  }
+  if (keys.size() > limit) {
+    keys.resize(limit);
+  }
+  return keys;
 }
 
 std::list<Name>
 Backend::listRecord(const Name& prefix) const
 {
     std::list<Name> names;
-    leveldb::Iterator* it = m_db->NewIterator(leveldb::ReadOptions());
-    for (it->Seek(prefix.toUri()); it->Valid() && prefix.isPrefixOf(Name(it->key().ToString())); it->Next()) {
-        names.emplace_back(it->key().ToString());
+    const auto& prefixKey = makeKey(prefix);
+    for (const auto& key : listKeys(std::max(prefixKey, RECORD_KEYS_BEGIN), getPrefixEnd(prefixKey))) {
+        names.push_back(keyToName(key));
     }
-    assert(it->status().ok());  // Check for any errors found during the scan
-    delete it;
-    return std::move(names);
+    return names;
+}
+
+std::list<Name>
+Backend::listRecord(const Name& prefix, size_t limit, std::string& cursor) const
+{
+  std::list<Name> names;
+  if (limit == 0) {
+    return names;
+  }
+  const auto& prefixKey = makeKey(prefix);
+  auto begin = std::max(prefixKey, RECORD_KEYS_BEGIN);
+  if (!cursor.empty()) {
+    // the smallest key after the cursor
+    begin = std::max(begin, cursor + '\0');
+  }
+  auto keys = listKeys(begin, getPrefixEnd(prefixKey), limit);
+  cursor = keys.size() < limit ? "" : keys.back();
+  for (const auto& key : keys) {
+    names.push_back(keyToName(key));
+  }
+  return names;
+}
+
+std::list<Name>
+Backend::listIndex(const std::string& indexPrefix, const time::system_clock::TimePoint& since,
+                   const time::system_clock::TimePoint& until) const
+{
+  std::list<Name> names;
+  size_t recordKeyOffset = indexPrefix.size() + sizeof(uint64_t);
+  for (const auto& key : listKeys(indexPrefix + encodeTimestamp(since), indexPrefix + encodeTimestamp(until))) {
+    names.push_back(keyToName(key.substr(recordKeyOffset)));
+  }
+  return names;
+}
+
+std::list<Name>
+Backend::listIndex(const std::string& indexPrefix, const time::system_clock::TimePoint& since,
+                   const time::system_clock::TimePoint& until, size_t limit, std::string& cursor) const
+{
+  std::list<Name> names;
+  if (limit == 0) {
+    return names;
+  }
+  auto begin = indexPrefix + encodeTimestamp(since);
+  if (!cursor.empty()) {
+    // the smallest key after the cursor
+    begin = std::max(begin, cursor + '\0');
+  }
+  auto keys = listKeys(begin, indexPrefix + encodeTimestamp(until), limit);
+  cursor = keys.size() < limit ? "" : keys.back();
+  size_t recordKeyOffset = indexPrefix.size() + sizeof(uint64_t);
+  for (const auto& key : keys) {
+    names.push_back(keyToName(key.substr(recordKeyOffset)));
+  }
+  return names;
+}
+
+std::list<Name>
+Backend::listRecordByTime(const time::system_clock::TimePoint& since, const time::system_clock::TimePoint& until) const
+{
+  return listIndex(TIME_INDEX, since, until);
+}
+
+std::list<Name>
+Backend::listRecordByTime(const time::system_clock::TimePoint& since, const time::system_clock::TimePoint& until,
+                          size_t limit, std::string& cursor) const
+{
+  return listIndex(TIME_INDEX, since, until, limit, cursor);
+}
+
+std::list<Name>
+Backend::listRecordByType(RecordType type, const time::system_clock::TimePoint& since,
+                          const time::system_clock::TimePoint& until) const
+{
+  return listIndex(TYPE_INDEX + static_cast<char>(type), since, until);
+}
+
+std::list<Name>
+Backend::listRecordByProducer(const Name& producerPrefix, const time::system_clock::TimePoint& since,
+                              const time::system_clock::TimePoint& until) const
+{
+  const auto& producer = producerPrefix.wireEncode();
+  return listIndex(PRODUCER_INDEX + std::string(reinterpret_cast<const char*>(producer.wire()), producer.size()),
+                   since, until);
 }
 
-}  // namespace dledger
\ No newline at end of file
+}  // namespace dledger
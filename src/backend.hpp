@@ -1,16 +1,32 @@
 #ifndef DLEDGER_SRC_BACKEND_H_
 #define DLEDGER_SRC_BACKEND_H_
 
-#include <leveldb/db.h>
+#include "bloom-filter.hpp"
+#include "storage-engine.hpp"
+
+#include "dledger/record.hpp"
 
 #include <ndn-cxx/data.hpp>
 
+#include <map>
+
 using namespace ndn;
 namespace dledger {
 
+/**
+ * The record store on top of a StorageEngine, LevelDB or the append-only log.
+ * Records are keyed by the TLV encoding of their name components, so the records under a name
+ * prefix are a contiguous byte range of keys. An in-memory Bloom filter over the keys answers most
+ * lookups of absent records without reading the database.
+ * Each record name is also indexed by generation time, by type and time, and by producer and time.
+ * The index entries are keys under a leading zero byte, which no name component starts with.
+ * Writes are grouped into a batch and committed together by flush(), which is called once
+ * the batch holds maxPendingWrites records or by the owner on a timer. Reads see the pending
+ * writes, so a record is visible as soon as putRecord() returns.
+ */
 class Backend {
 public:
-  Backend(const std::string& dbDir);
+  Backend(const std::string& dbDir, size_t maxPendingWrites = 1, const std::string& engineType = "leveldb");
 
 public:
   ~Backend();
@@ -28,10 +44,126 @@ public:
   std::list<Name>
   listRecord(const Name& prefix) const;
 
+  /**
+   * lists a page of the records under the prefix, in key order
+   * @param limit the maximum number of records in the page
+   * @param cursor the key of the last record of the previous page, or empty for the first page;
+   *               set to the key of the last record in this page, or to empty after the last page
+   */
+  std::list<Name>
+  listRecord(const Name& prefix, size_t limit, std::string& cursor) const;
+
+  /**
+   * @return the names of the records generated in [since, until), in generation order
+   */
+  std::list<Name>
+  listRecordByTime(const time::system_clock::TimePoint& since, const time::system_clock::TimePoint& until) const;
+
+  /**
+   * lists a page of the records generated in [since, until), in generation order
+   * @param cursor as in the paged listRecord
+   */
+  std::list<Name>
+  listRecordByTime(const time::system_clock::TimePoint& since, const time::system_clock::TimePoint& until,
+                   size_t limit, std::string& cursor) const;
+
+  /**
+   * @return the names of the records of the type generated in [since, until), in generation order
+   */
+  std::list<Name>
+  listRecordByType(RecordType type, const time::system_clock::TimePoint& since,
+                   const time::system_clock::TimePoint& until) const;
+
+  std::list<Name>
+  listIndex(const std::string& indexPrefix, const time::system_clock::TimePoint& since,
+            const time::system_clock::TimePoint& until, size_t limit, std::string& cursor) const;
+
+  /**
+   * @return the names of the records of the producer generated in [since, until), in generation order
+   */
+  std::list<Name>
+  listRecordByProducer(const Name& producerPrefix, const time::system_clock::TimePoint& since,
+                       const time::system_clock::TimePoint& until) const;
+
+  /**
+   * Commit the pending writes to the database in one batch.
+   * @return false if the write failed; the writes are then kept pending for the next flush
+   */
+  bool
+  flush();
+
+  bool
+  hasPendingWrites() const
+  {
+    return !m_pendingWrites.empty();
+  }
+
+private:
+  /**
+   * @return the key of the name: the TLV wire encoding of its components
+   */
+  static std::string
+  makeKey(const Name& recordName);
+
+  static Name
+  keyToName(const std::string& key);
+
+  /**
+   * @return the key right after all the keys starting with the prefix, or an empty key if none is
+   */
+  static std::string
+  getPrefixEnd(const std::string& prefix);
+
+  /**
+   * @return the index keys of the record, or nothing if the name is not a record name
+   */
+  static std::vector<std::string>
+  makeIndexKeys(const Name& recordName, const std::string& recordKey);
+
+  /**
+   * @return the first keys in [begin, end), at most @p limit, of the database merged with the pending writes
+   */
+  std::vector<std::string>
+  listKeys(const std::string& begin, const std::string& end,
+           size_t limit = std::numeric_limits<size_t>::max()) const;
+
+  std::list<Name>
+  listIndex(const std::string& indexPrefix, const time::system_clock::TimePoint& since,
+            const time::system_clock::TimePoint& until) const;
+
+  /**
+   * index the records of a database written before the indexes
+   */
+  void
+  buildIndexes();
+
+  static uint64_t
+  hashKey(const std::string& key);
+
+  /**
+   * rebuild the key filter from the database, sized for twice the stored records
+   */
+  void
+  rebuildFilter();
+
 private:
-  leveldb::DB* m_db;
+  struct PendingWrite {
+    bool isDeleted;
+    shared_ptr<const Data> record; // nullptr for an index entry
+  };
+
+  static const std::string RECORD_KEYS_BEGIN;
+  static const std::string INDEXED_KEY;
+  static const std::string TIME_INDEX;
+  static const std::string TYPE_INDEX;
+  static const std::string PRODUCER_INDEX;
+  std::unique_ptr<StorageEngine> m_engine;
+  BloomFilter m_filter; // record keys ever written, including the pending writes
+  size_t m_maxPendingWrites;
+  size_t m_pendingRecordCount = 0;
+  std::map<std::string, PendingWrite> m_pendingWrites;
 };
 
 }  // namespace dledger
 
-#endif  // DLEDGER_SRC_BACKEND_H_
\ No newline at end of file
+#endif  // DLEDGER_SRC_BACKEND_H_
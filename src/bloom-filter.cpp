@@ -0,0 +1,43 @@
+#include "bloom-filter.hpp"
+
+#include <algorithm>
+
+namespace dledger {
+
+BloomFilter::BloomFilter(size_t capacity, size_t bitsPerEntry)
+    : m_capacity(std::max<size_t>(capacity, 1))
+    , m_numBlocks((m_capacity * bitsPerEntry + BLOCK_WORDS * 64 - 1) / (BLOCK_WORDS * 64))
+    , m_words(m_numBlocks * BLOCK_WORDS, 0)
+{
+}
+
+void
+BloomFilter::insert(uint64_t hash)
+{
+  // the upper half picks the block, the lower half derives the probes inside it
+  uint64_t* block = &m_words[(hash >> 32) % m_numBlocks * BLOCK_WORDS];
+  uint32_t h1 = static_cast<uint32_t>(hash);
+  uint32_t h2 = static_cast<uint32_t>(hash >> 17) | 1;
+  for (size_t i = 0; i < NUM_PROBES; i++) {
+    uint32_t bit = (h1 + i * h2) % (BLOCK_WORDS * 64);
+    block[bit / 64] |= uint64_t(1) << (bit % 64);
+  }
+  m_count++;
+}
+
+bool
+BloomFilter::mayContain(uint64_t hash) const
+{
+  const uint64_t* block = &m_words[(hash >> 32) % m_numBlocks * BLOCK_WORDS];
+  uint32_t h1 = static_cast<uint32_t>(hash);
+  uint32_t h2 = static_cast<uint32_t>(hash >> 17) | 1;
+  for (size_t i = 0; i < NUM_PROBES; i++) {
+    uint32_t bit = (h1 + i * h2) % (BLOCK_WORDS * 64);
+    if ((block[bit / 64] & (uint64_t(1) << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace dledger
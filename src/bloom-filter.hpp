@@ -0,0 +1,61 @@
+#ifndef DLEDGER_SRC_BLOOM_FILTER_H_
+#define DLEDGER_SRC_BLOOM_FILTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dledger {
+
+/**
+ * A blocked Bloom filter over 64-bit hashes.
+ * All the bits of an entry are set in one 512-bit block, so a lookup touches one cache line.
+ * Entries cannot be removed; a lookup may return false positives but never false negatives.
+ */
+class BloomFilter
+{
+public:
+  /**
+   * @param capacity the number of entries the filter is sized for
+   * @param bitsPerEntry the number of bits per entry; 10 bits give about 1% false positives
+   */
+  explicit
+  BloomFilter(size_t capacity = 1024, size_t bitsPerEntry = 10);
+
+  void
+  insert(uint64_t hash);
+
+  /**
+   * @return false if the hash was never inserted
+   */
+  bool
+  mayContain(uint64_t hash) const;
+
+  /**
+   * @return the number of insertions
+   */
+  size_t
+  size() const
+  {
+    return m_count;
+  }
+
+  size_t
+  getCapacity() const
+  {
+    return m_capacity;
+  }
+
+private:
+  static const size_t BLOCK_WORDS = 8;
+  static const size_t NUM_PROBES = 7;
+
+  size_t m_capacity;
+  size_t m_numBlocks;
+  std::vector<uint64_t> m_words;
+  size_t m_count = 0;
+};
+
+}  // namespace dledger
+
+#endif  // DLEDGER_SRC_BLOOM_FILTER_H_
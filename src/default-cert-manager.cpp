@@ -12,28 +12,104 @@ dledger::DefaultCertificateManager::DefaultCertificateManager(const Name &peerPr
                                                               shared_ptr<security::Certificate> anchorCert,
                                                               const std::list<security::Certificate> &startingPeers)
         :
-        m_peerPrefix(peerPrefix), m_anchorCert(std::move(anchorCert)) {
+        m_peerPrefix(peerPrefix), m_anchorCert(std::move(anchorCert)),
+        m_verificationCache(VERIFICATION_CACHE_CAPACITY) {
     if (!m_anchorCert->isValid()) {
         BOOST_THROW_EXCEPTION(std::runtime_error("trust Anchor Expired"));
     }
-    m_peerCertificates[m_anchorCert->getIdentity()].push_back(*m_anchorCert);
+    addCertificate(*m_anchorCert);
     for (const auto &certificate: startingPeers) {
-        m_peerCertificates[certificate.getIdentity()].push_back(certificate);
+        addCertificate(certificate);
     }
 }
 
+void dledger::DefaultCertificateManager::addCertificate(const security::Certificate &cert) {
+    auto entry = make_shared<CertificateEntry>();
+    entry->certificate = cert;
+    entry->fullName = cert.getFullName();
+    if (m_certificates.count(entry->fullName)) return;
+    try {
+        auto publicKey = make_shared<security::transform::PublicKey>();
+        publicKey->loadPkcs8(cert.getPublicKey().data(), cert.getPublicKey().size());
+        entry->publicKey = publicKey;
+    } catch (const std::exception &e) {
+        // verified with the certificate itself, which fails the same way
+        std::cout << "-- Unable to parse the public key of " << cert.getName() << std::endl;
+    }
+    entry->isRevoked = m_revokedCertificates.count(entry->fullName) != 0;
+    m_certificates[entry->fullName] = entry;
+    m_certificatesByKey[cert.getKeyName()].push_back(entry);
+    m_certifiedIdentities.insert(cert.getIdentity());
+}
+
+Name dledger::DefaultCertificateManager::getSigningKeyName(const SignatureInfo &info) {
+    if (!info.hasKeyLocator() || info.getKeyLocator().getType() != tlv::Name) return Name();
+    const auto &locator = info.getKeyLocator().getName();
+    // a certificate name is /<identity>/KEY/<key-id>/<issuer-id>/<version>
+    return security::Certificate::isValidName(locator) ? locator.getPrefix(-2) : locator;
+}
+
 bool dledger::DefaultCertificateManager::verifySignature(const Data &data) const {
+    return verifyWithSigningKey(data, true);
+}
+
+std::vector<bool>
+dledger::DefaultCertificateManager::verifySignatures(const std::vector<shared_ptr<const Data>> &records) const {
+    std::vector<bool> results;
+    for (const auto &data : records) {
+        try {
+            results.push_back(verifyWithSigningKey(*data, true));
+        } catch (const std::exception &e) {
+            // not a record name
+            results.push_back(false);
+        }
+    }
+    return results;
+}
+
+std::vector<shared_ptr<const dledger::DefaultCertificateManager::CertificateEntry>>
+dledger::DefaultCertificateManager::findSigningCertificates(const Data &data, bool isRevokedAllowed) const {
+    std::vector<shared_ptr<const CertificateEntry>> entries;
     auto identity = RecordName(data.getName()).getProducerPrefix();
-    auto iterator = m_peerCertificates.find(identity);
-    if (iterator == m_peerCertificates.cend()) return false;
-    for (const auto &cert : iterator->second) {
-        if (security::verifySignature(data, cert)) {
+    auto keyName = getSigningKeyName(data.getSignature().getSignatureInfo());
+    std::shared_lock<std::shared_timed_mutex> lock(m_certificatesMutex);
+    auto iterator = m_certificatesByKey.find(keyName);
+    if (iterator == m_certificatesByKey.cend()) return entries;
+    for (const auto &entry : iterator->second) {
+        if (entry->isRevoked && !isRevokedAllowed) continue;
+        if (entry->certificate.getIdentity() != identity) continue;
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+bool dledger::DefaultCertificateManager::verifyWithSigningKey(const Data &data, bool isRevokedAllowed) const {
+    for (const auto &entry : findSigningCertificates(data, isRevokedAllowed)) {
+        if (verifyWithCertificate(data, *entry)) {
             return true;
         }
     }
     return false;
 }
 
+bool dledger::DefaultCertificateManager::verifyWithCertificate(const Data &data,
+                                                               const CertificateEntry &entry) const {
+    Name key = entry.fullName;
+    key.append(data.getFullName().get(-1));
+    {
+        std::lock_guard<std::mutex> lock(m_verificationCacheMutex);
+        auto result = m_verificationCache.find(key);
+        if (result != nullptr) {
+            return *result;
+        }
+    }
+    // verified without the cache lock, so that threads verify in parallel
+    bool isValid = entry.publicKey != nullptr ? security::verifySignature(data, *entry.publicKey)
+                                              : security::verifySignature(data, entry.certificate);
+    std::lock_guard<std::mutex> lock(m_verificationCacheMutex);
+    return m_verificationCache.insert(key, isValid);
+}
+
 bool dledger::DefaultCertificateManager::verifyRecordFormat(const dledger::Record &record) const {
 
     if (record.getType() == RecordType::CERTIFICATE_RECORD) {
@@ -81,26 +157,23 @@ bool dledger::DefaultCertificateManager::verifyRecordFormat(const dledger::Recor
 }
 
 bool dledger::DefaultCertificateManager::endorseSignature(const Data &data) const {
-    auto identity = RecordName(data.getName()).getProducerPrefix();
-    auto iterator = m_peerCertificates.find(identity);
-    if (iterator == m_peerCertificates.cend()) return false;
-    for (const auto &cert : iterator->second) {
-        if (m_revokedCertificates.count(cert.getFullName())) continue;
-        if (security::verifySignature(data, cert)) {
-            return true;
-        }
-    }
-    return false;
+    return verifyWithSigningKey(data, false);
 }
 
 bool dledger::DefaultCertificateManager::verifySignature(const Interest &interest) const {
     SignatureInfo info(interest.getName().get(-2).blockFromValue());
-    auto identity = info.getKeyLocator().getName().getPrefix(-2);
-    auto iterator = m_peerCertificates.find(identity);
-    if (iterator == m_peerCertificates.cend()) return false;
-    for (const auto &cert : iterator->second) {
-        if (m_revokedCertificates.count(cert.getFullName())) continue;
-        if (security::verifySignature(interest, cert)) {
+    std::vector<shared_ptr<const CertificateEntry>> entries;
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(m_certificatesMutex);
+        auto iterator = m_certificatesByKey.find(getSigningKeyName(info));
+        if (iterator == m_certificatesByKey.cend()) return false;
+        for (const auto &entry : iterator->second) {
+            if (!entry->isRevoked) entries.push_back(entry);
+        }
+    }
+    for (const auto &entry : entries) {
+        if (entry->publicKey != nullptr ? security::verifySignature(interest, *entry->publicKey)
+                                        : security::verifySignature(interest, entry->certificate)) {
             return true;
         }
     }
@@ -108,6 +181,7 @@ bool dledger::DefaultCertificateManager::verifySignature(const Interest &interes
 }
 
 void dledger::DefaultCertificateManager::acceptRecord(const dledger::Record &record) {
+    std::unique_lock<std::shared_timed_mutex> lock(m_certificatesMutex);
     if (record.getType() == RecordType::CERTIFICATE_RECORD) {
         try {
             auto certRecord = CertificateRecord(record);
@@ -115,7 +189,7 @@ void dledger::DefaultCertificateManager::acceptRecord(const dledger::Record &rec
                 if (m_revokedCertificates.count(cert.getFullName()))
                     continue;
                 std::cout << "Insert certificate " << cert.getName() << std::endl;
-                m_peerCertificates[cert.getIdentity()].push_back(cert);
+                addCertificate(cert);
             }
         } catch (const std::exception &e) {
             std::cout << "-- Bad certificate record format. " << std::endl;
@@ -127,6 +201,12 @@ void dledger::DefaultCertificateManager::acceptRecord(const dledger::Record &rec
             for (const auto &certName: revokeRecord.getRevokedCertificates()) {
                 std::cout << "Revoke certificate " << certName << std::endl;
                 m_revokedCertificates.insert(certName);
+                auto entry = m_certificates.find(certName);
+                if (entry != m_certificates.end()) {
+                    entry->second->isRevoked = true;
+                }
+                std::lock_guard<std::mutex> cacheLock(m_verificationCacheMutex);
+                m_verificationCache.erasePrefix(certName);
             }
         } catch (const std::exception &e) {
             std::cout << "-- Bad revocation record format. " << std::endl;
@@ -144,7 +224,6 @@ Name dledger::DefaultCertificateManager::getCertificateNameIdentity(const Name &
 }
 
 bool dledger::DefaultCertificateManager::authorizedToGenerate() const {
-    auto iterator = m_peerCertificates.find(m_peerPrefix);
-    if (iterator == m_peerCertificates.cend()) return false;
-    return !iterator->second.empty();
+    std::shared_lock<std::shared_timed_mutex> lock(m_certificatesMutex);
+    return m_certifiedIdentities.count(m_peerPrefix) != 0;
 }
@@ -5,8 +5,13 @@
 #ifndef DLEDGER_DEFAULT_CERT_MANAGER_H
 #define DLEDGER_DEFAULT_CERT_MANAGER_H
 
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 #include <unordered_set>
 #include "dledger/cert-manager.hpp"
+#include <ndn-cxx/security/transform/public-key.hpp>
+#include "lru-cache.hpp"
 
 using namespace ndn;
 namespace dledger {
@@ -19,6 +24,8 @@ namespace dledger {
 
         bool verifySignature(const Data &data) const override;
 
+        std::vector<bool> verifySignatures(const std::vector<shared_ptr<const Data>> &records) const override;
+
         bool verifyRecordFormat(const Record &record) const override;
 
         bool endorseSignature(const Data &data) const override;
@@ -32,10 +39,58 @@ namespace dledger {
     private:
         Name getCertificateNameIdentity(const Name &certificateName) const;
 
+        struct CertificateEntry {
+            security::Certificate certificate;
+            Name fullName;
+            shared_ptr<const security::transform::PublicKey> publicKey; // nullptr if the key does not parse
+            bool isRevoked;
+        };
+
+        /**
+         * @return the key name in the KeyLocator, which names either the key or one of its certificates;
+         *         empty if the KeyLocator holds no name
+         */
+        static Name getSigningKeyName(const SignatureInfo &info);
+
+        /**
+         * @return the certificates of the data signing key that belong to the producer, copied under
+         *         a short shared lock, so that the signatures are verified without holding the lock
+         */
+        std::vector<shared_ptr<const CertificateEntry>>
+        findSigningCertificates(const Data &data, bool isRevokedAllowed) const;
+
+        /**
+         * verifies the data signature with the certificates of its signing key that belong to the producer
+         */
+        bool verifyWithSigningKey(const Data &data, bool isRevokedAllowed) const;
+
+        /**
+         * verifies the data signature with the certificate, or returns the cached result
+         * of an earlier verification of the same data with the same certificate
+         */
+        bool verifyWithCertificate(const Data &data, const CertificateEntry &entry) const;
+
+        /**
+         * indexes the certificate, with its public key parsed once
+         */
+        void addCertificate(const security::Certificate &cert);
+
+        const static size_t VERIFICATION_CACHE_CAPACITY = 4096;
+
         Name m_peerPrefix;
         std::shared_ptr<security::Certificate> m_anchorCert;
-        std::map<Name, std::list<security::Certificate>> m_peerCertificates; // first: name of the peer, second: certificate
-        std::unordered_set<Name> m_revokedCertificates;
+        // the verifications may run on several threads: they share the lock of the certificates only
+        // to look up the entries, and acceptRecord takes it exclusively; the certificate, full name and
+        // public key of an entry never change once it is indexed
+        mutable std::shared_timed_mutex m_certificatesMutex;
+        std::unordered_map<Name, shared_ptr<CertificateEntry>> m_certificates; // certificate full name -> entry
+        // key name -> certificates of the key; a signature names its key, so no other certificate is tried
+        std::unordered_map<Name, std::vector<shared_ptr<CertificateEntry>>> m_certificatesByKey;
+        std::unordered_set<Name> m_certifiedIdentities; // identities with a certificate, revoked or not
+        std::unordered_set<Name> m_revokedCertificates; // including the ones not seen yet
+        // /<certificate full name>/<data implicit digest> -> result of the signature verification
+        mutable std::mutex m_verificationCacheMutex;
+        mutable LruCache<bool> m_verificationCache;
     };
 };
 
@@ -1,4 +1,5 @@
 #include "ledger-impl.hpp"
+#include "record-batch.hpp"
 #include "record_name.hpp"
 
 #include <algorithm>
@@ -11,6 +12,10 @@
 #include <ndn-cxx/util/logging.hpp>
 #include <random>
 #include <sstream>
+#include <cstring>
+#include <ndn-cxx/util/sha256.hpp>
+#include <ndn-cxx/util/segment-fetcher.hpp>
+#include <set>
 
 NDN_LOG_INIT(dledger.impl);
 
@@ -22,14 +27,62 @@ int max(int a, int b) {
 }
 
 void
-LedgerImpl::dumpList(const std::map<Name, TailingRecordState>& weight)
+LedgerImpl::dumpList() const
 {
-    NDN_LOG_TRACE("Dump " << weight.size() << " Tailing Records");
-  for (const auto& item : weight) {
-    NDN_LOG_TRACE((item.second.parentEndorseVerified ? "OK " : "NO ") << item.second.refSet.size() << "\t" << item.first.toUri());
+    NDN_LOG_TRACE("Record cache: " << m_recordCache.size() << " records, "
+                  << m_recordCache.getHitCount() << " hits, " << m_recordCache.getMissCount() << " misses");
+    NDN_LOG_TRACE("Dump " << m_tailRecords.size() << " Tailing Records");
+  for (const auto& item : m_tailRecords) {
+    NDN_LOG_TRACE((item.second.parentEndorseVerified ? "OK " : "NO ") << getWeight(item.first) << "\t" << m_recordNames.getName(item.first).toUri());
   }
 }
 
+LedgerImpl::TailingRecordState*
+LedgerImpl::findTailingRecord(const Name& recordName)
+{
+  auto handle = m_recordNames.find(recordName);
+  if (handle == NameTable::INVALID_HANDLE) return nullptr;
+  auto it = m_tailRecords.find(handle);
+  return it == m_tailRecords.end() ? nullptr : &it->second;
+}
+
+const LedgerImpl::TailingRecordState*
+LedgerImpl::findTailingRecord(const Name& recordName) const
+{
+  auto handle = m_recordNames.find(recordName);
+  if (handle == NameTable::INVALID_HANDLE) return nullptr;
+  auto it = m_tailRecords.find(handle);
+  return it == m_tailRecords.end() ? nullptr : &it->second;
+}
+
+size_t
+LedgerImpl::getWeight(NameHandle record) const
+{
+  return m_weightEngine.getWeight(record);
+}
+
+NameHandle
+LedgerImpl::getProducerHandle(const Name& producerPrefix)
+{
+  auto handle = m_producerNames.find(producerPrefix);
+  if (handle == NameTable::INVALID_HANDLE) {
+    handle = m_producerNames.acquire(producerPrefix);
+  }
+  return handle;
+}
+
+void
+LedgerImpl::removeTailingRecord(NameHandle record)
+{
+  if (m_tailRecords.erase(record) == 0) return;
+  auto digest = m_tailingDigests.find(getTruncatedDigest(m_recordNames.getName(record)));
+  if (digest != m_tailingDigests.end() && digest->second == record) {
+    m_tailingDigests.erase(digest);
+  }
+  m_weightEngine.removeRecord(record);
+  m_recordNames.release(record);
+}
+
 LedgerImpl::LedgerImpl(const Config& config,
                        security::KeyChain& keychain,
                        Face& network)
@@ -38,7 +91,12 @@ LedgerImpl::LedgerImpl(const Config& config,
     , m_keychain(keychain)
     , m_network(network)
     , m_scheduler(network.getIoService())
-    , m_backend(config.databasePath)
+    , m_backend(config.databasePath, config.backendWriteBatchSize, config.storageEngine)
+    , m_recordCache(config.recordCacheCapacity)
+    , m_fetcher(network, m_scheduler, config.fetchWindowSize, config.fetchRetryLimit, config.fetchRetryBackoff,
+                bind(&LedgerImpl::onFetchedRecord, this, _1, _2))
+    , m_syncBuckets(config.maxReconcileBuckets)
+    , m_verificationPool(network.getIoService(), config.verificationThreads)
 {
   NDN_LOG_INFO("DLedger Initialization Start");
 
@@ -48,6 +106,21 @@ LedgerImpl::LedgerImpl(const Config& config,
     NDN_LOG_ERROR("invalid weight configuration");
     BOOST_THROW_EXCEPTION(std::runtime_error("invalid weight configuration"));
   }
+  if (m_config.reconcileBucketWidth <= time::milliseconds::zero()) {
+    NDN_LOG_ERROR("invalid reconcile bucket width");
+    BOOST_THROW_EXCEPTION(std::runtime_error("invalid reconcile bucket width"));
+  }
+
+  // summarize the latest buckets of the records accepted in previous runs
+  m_syncBuckets.advance(getBucket(time::system_clock::now()));
+  std::string cursor;
+  do {
+    for (const auto& recordName : m_backend.listRecordByTime(getBucketStart(m_syncBuckets.getFirstBucket()),
+                                                             time::system_clock::TimePoint::max(),
+                                                             BUCKET_SCAN_PAGE_SIZE, cursor)) {
+      addToSyncBuckets(recordName);
+    }
+  } while (!cursor.empty());
 
   //****STEP 1****
   // Register the prefix to local NFD
@@ -66,11 +139,9 @@ LedgerImpl::LedgerImpl(const Config& config,
     GenesisRecord genesisRecord((std::to_string(i)));
     RecordName recordName = RecordName::generateRecordName(config, genesisRecord);
     auto data = make_shared<Data>(recordName);
-    auto contentBlock = makeEmptyBlock(tlv::Content);
-    genesisRecord.wireEncode(contentBlock);
-    data->setContent(contentBlock);
+    data->setContent(genesisRecord.wireEncode());
     m_keychain.sign(*data, signingWithSha256());
-    genesisRecord.m_data = data;
+    genesisRecord.setData(data);
     addToTailingRecord(genesisRecord, true);
   }
   NDN_LOG_INFO("STEP 2" << std::endl
@@ -83,6 +154,8 @@ LedgerImpl::LedgerImpl(const Config& config,
 LedgerImpl::~LedgerImpl()
 {
     if (m_syncEventID) m_syncEventID.cancel();
+    if (m_expiryEventID) m_expiryEventID.cancel();
+    if (m_flushEventID) m_flushEventID.cancel();
 }
 
 ReturnCode
@@ -97,7 +170,8 @@ LedgerImpl::createRecord(Record& record)
   }
 
   if (record.getType() == CERTIFICATE_RECORD) {
-      for (const auto& certName: m_lastCertRecords) {
+      for (const auto& certHandle: m_lastCertRecords) {
+          const auto& certName = m_recordNames.getName(certHandle);
           NDN_LOG_INFO("[LedgerImpl::addRecord] Certificate record: Add previous cert record: " << certName);
           record.addRecordItem(KeyLocator(certName).wireEncode());
       }
@@ -105,10 +179,11 @@ LedgerImpl::createRecord(Record& record)
 
   std::vector<std::pair<Name, int>> recordList;
   for (const auto &item : m_tailRecords) {
-    if (item.second.refSet.size() <= m_config.appendWeight &&
-        !m_config.peerPrefix.isPrefixOf(item.first) &&
+    const auto& recordName = m_recordNames.getName(item.first);
+    if (getWeight(item.first) <= m_config.appendWeight &&
+        !m_config.peerPrefix.isPrefixOf(recordName) &&
         item.second.parentEndorseVerified) {
-      recordList.emplace_back(item.first, item.second.refSet.size());
+      recordList.emplace_back(recordName, getWeight(item.first));
     }
   }
 
@@ -129,9 +204,7 @@ LedgerImpl::createRecord(Record& record)
 
   Name dataName = RecordName::generateRecordName(m_config, record);
   auto data = make_shared<Data>(dataName);
-  auto contentBlock = makeEmptyBlock(tlv::Content);
-  record.wireEncode(contentBlock);
-  data->setContent(contentBlock);
+  data->setContent(record.wireEncode());
   data->setFreshnessPeriod(time::minutes(5));
 
   // sign the packet with peer's key
@@ -141,7 +214,7 @@ LedgerImpl::createRecord(Record& record)
   catch (const std::exception& e) {
     return ReturnCode::signingError(e.what());
   }
-  record.m_data = data;
+  record.setData(data);
   NDN_LOG_INFO("[LedgerImpl::addRecord] Added a new record:" << data->getFullName().toUri());
 
   // add new record into the ledger
@@ -165,50 +238,117 @@ LedgerImpl::getRecord(const std::string& recordName) const
 bool
 LedgerImpl::hasRecord(const std::string& recordName) const
 {
-  if (m_tailRecords.count(recordName)) {
-    if (!m_tailRecords.find(recordName)->second.parentEndorseVerified) {
-      return false;
-    }
-    return true;
-  }
-  auto dataPtr = m_backend.getRecord(Name(recordName));
-  return dataPtr != nullptr;
+  Name rName = recordName;
+  return hasRecord(rName);
 }
 
 std::list<Name>
 LedgerImpl::listRecord(const std::string& prefix) const
 {
     auto list = m_backend.listRecord(Name(prefix));
-    list.remove_if([&](const auto& name) {return m_tailRecords.count(name) && !m_tailRecords.find(name)->second.parentEndorseVerified;});
+    removeUnverifiedRecords(list);
     return list;
 }
 
+std::list<Name>
+LedgerImpl::listRecord(const std::string& prefix, size_t pageSize, std::string& cursor) const
+{
+  std::list<Name> page;
+  if (pageSize == 0) {
+    return page;
+  }
+  // the filtered records are skipped, so keep reading until the page is full or the records run out
+  do {
+    auto names = m_backend.listRecord(Name(prefix), pageSize - page.size(), cursor);
+    removeUnverifiedRecords(names);
+    page.splice(page.end(), names);
+  } while (!cursor.empty() && page.size() < pageSize);
+  return page;
+}
+
+std::list<Name>
+LedgerImpl::listRecordByType(RecordType type, const time::system_clock::TimePoint& since,
+                             const time::system_clock::TimePoint& until) const
+{
+  auto list = m_backend.listRecordByType(type, since, until);
+  removeUnverifiedRecords(list);
+  return list;
+}
+
+std::list<Name>
+LedgerImpl::listRecordByProducer(const std::string& producerPrefix, const time::system_clock::TimePoint& since,
+                                 const time::system_clock::TimePoint& until) const
+{
+  auto list = m_backend.listRecordByProducer(Name(producerPrefix), since, until);
+  removeUnverifiedRecords(list);
+  return list;
+}
+
+std::list<Name>
+LedgerImpl::listRecordByTime(const time::system_clock::TimePoint& since,
+                             const time::system_clock::TimePoint& until) const
+{
+  auto list = m_backend.listRecordByTime(since, until);
+  removeUnverifiedRecords(list);
+  return list;
+}
+
+void
+LedgerImpl::removeUnverifiedRecords(std::list<Name>& recordNames) const
+{
+  recordNames.remove_if([&](const auto& name) {
+    auto tailingState = findTailingRecord(name);
+    return tailingState != nullptr && !tailingState->parentEndorseVerified;
+  });
+}
+
 optional<Record>
 LedgerImpl::getRecord(const Name& rName) const
 {
-  if (m_tailRecords.count(rName)) {
-    if (!m_tailRecords.find(rName)->second.parentEndorseVerified) {
+  if (auto tailingState = findTailingRecord(rName)) {
+    if (!tailingState->parentEndorseVerified) {
       return nullopt;
     }
-    return m_tailRecords.find(rName)->second.record;
+    return tailingState->record;
   }
-  auto dataPtr = m_backend.getRecord(rName);
-  if (dataPtr != nullptr) {
-    return Record(dataPtr);
+  auto confirmedRecord = findConfirmedRecord(rName);
+  if (confirmedRecord != nullptr) {
+    return *confirmedRecord;
   }
   else {
     return nullopt;
   }
 }
 
+const Record*
+LedgerImpl::findConfirmedRecord(const Name& recordName) const
+{
+  if (auto cachedRecord = m_recordCache.find(recordName)) {
+    return cachedRecord;
+  }
+  auto dataPtr = m_backend.getRecord(recordName);
+  if (dataPtr == nullptr) {
+    return nullptr;
+  }
+  return &m_recordCache.insert(recordName, Record(dataPtr));
+}
+
+bool
+LedgerImpl::hasRecord(const Name& rName) const
+{
+  if (auto tailingState = findTailingRecord(rName)) {
+    return tailingState->parentEndorseVerified;
+  }
+  return findConfirmedRecord(rName) != nullptr;
+}
+
 bool
 LedgerImpl::seenRecord(const Name& recordName) const
 {
-  if (m_tailRecords.count(recordName)) {
+  if (findTailingRecord(recordName) != nullptr) {
     return true;
   }
-  auto dataPtr = m_backend.getRecord(Name(recordName));
-  return dataPtr != nullptr;
+  return findConfirmedRecord(recordName) != nullptr;
 }
 
 
@@ -218,12 +358,6 @@ LedgerImpl::onNack(const Interest&, const lp::Nack& nack)
   NDN_LOG_ERROR("Received Nack with reason " << nack.getReason());
 }
 
-void
-LedgerImpl::onTimeout(const Interest& interest)
-{
-  NDN_LOG_ERROR("Timeout for " << interest);
-}
-
 ReturnCode
 LedgerImpl::sendSyncInterest() {
     NDN_LOG_INFO("[LedgerImpl::sendSyncInterest] Send SYNC Interest.");
@@ -233,13 +367,33 @@ LedgerImpl::sendSyncInterest() {
     syncInterestName.append("SYNC");
     Interest syncInterest(syncInterestName);
     Block appParam = makeEmptyBlock(tlv::ApplicationParameters);
-    for (const auto &certName: m_lastCertRecords) {
-        appParam.push_back(KeyLocator(certName).wireEncode());
+    for (const auto &certHandle: m_lastCertRecords) {
+        appParam.push_back(KeyLocator(m_recordNames.getName(certHandle)).wireEncode());
     }
+
+    // tailing records are carried as truncated digests; the full names are served as a sync state
+    std::vector<Name> stateNames;
+    Buffer digests;
     for (const auto &item : m_tailRecords) {
-        if (item.second.parentEndorseVerified && item.second.refSet.empty())
-            appParam.push_back(item.first.wireEncode());
+        if (stateNames.size() >= m_config.maxSyncDigests) break;
+        if (item.second.parentEndorseVerified && getWeight(item.first) == 0) {
+            const auto& recordName = m_recordNames.getName(item.first);
+            uint64_t digest = getTruncatedDigest(recordName);
+            const auto* digestBytes = reinterpret_cast<const uint8_t*>(&digest);
+            digests.insert(digests.end(), digestBytes, digestBytes + sizeof(digest));
+            stateNames.push_back(recordName);
+        }
+    }
+    appParam.push_back(makeBinaryBlock(T_TailingDigests, digests.data(), digests.size()));
+    auto stateDigest = util::Sha256::computeDigest(digests.data(), digests.size());
+    Name stateName = m_config.peerPrefix;
+    stateName.append("SYNC-STATE").append(stateDigest->data(), sizeof(uint64_t));
+    appParam.push_back(Block(T_SyncStateName, stateName.wireEncode()));
+    m_syncStates.emplace_back(stateName, std::move(stateNames));
+    while (m_syncStates.size() > MAX_KEPT_SYNC_STATES) {
+        m_syncStates.pop_front();
     }
+
     appParam.parse();
     syncInterest.setApplicationParameters(appParam);
     syncInterest.setCanBePrefix(false);
@@ -260,55 +414,81 @@ LedgerImpl::sendSyncInterest() {
     return ReturnCode::noError();
 }
 
-bool
-LedgerImpl::checkSyntaxValidityOfRecord(const Data& data) {
-    NDN_LOG_INFO("[LedgerImpl::checkSyntaxValidityOfRecord] Check the format validity of the record");
-    NDN_LOG_TRACE("- Step 1: Check whether it is a valid record following DLedger record spec");
-    Record dataRecord;
-    try {
-        // format check
-        dataRecord = Record(data);
-        dataRecord.checkPointerCount(m_config.precedingRecordNum);
-    } catch (const std::exception &e) {
-        NDN_LOG_ERROR("[LedgerImpl::checkSyntaxValidityOfRecord] The Data format is not proper for DLedger record " << dataRecord.getRecordName() << " because " << e.what());
-        return false;
+uint64_t
+LedgerImpl::getTruncatedDigest(const Name& recordName)
+{
+    uint64_t digest = 0;
+    const auto& digestComponent = recordName.get(-1);
+    std::memcpy(&digest, digestComponent.value(), std::min(digestComponent.value_size(), sizeof(digest)));
+    return digest;
+}
+
+std::vector<optional<RecordView>>
+LedgerImpl::checkSignatureValidityOfRecords(const std::vector<shared_ptr<const Data>>& records) const {
+    NDN_LOG_INFO("[LedgerImpl::checkSignatureValidityOfRecords] Check the signatures of " << records.size() << " records");
+    NDN_LOG_TRACE("- Step 1: Check whether they are valid records following DLedger record spec");
+    std::vector<optional<RecordView>> views(records.size());
+    std::vector<size_t> wellFormed;
+    std::vector<shared_ptr<const Data>> wellFormedData;
+    for (size_t i = 0; i < records.size(); i++) {
+        try {
+            // format check; the only decoding of the record
+            views[i] = RecordView(records[i]);
+            views[i]->getRecord().checkPointerCount(m_config.precedingRecordNum);
+            wellFormed.push_back(i);
+            wellFormedData.push_back(records[i]);
+        } catch (const std::exception &e) {
+            NDN_LOG_ERROR("[LedgerImpl::checkSignatureValidityOfRecords] The Data format is not proper for DLedger record " << records[i]->getName() << " because " << e.what());
+            views[i] = nullopt;
+        }
     }
 
-    NDN_LOG_TRACE("- Step 2: Check signature");
-    Name producerID = dataRecord.getProducerPrefix();
-    if (!m_config.certificateManager->verifySignature(data)) {
-        NDN_LOG_ERROR("[LedgerImpl::checkSyntaxValidityOfRecord] Bad Signature for " << dataRecord.getRecordName());
-        return false;
+    NDN_LOG_TRACE("- Step 2: Check signatures");
+    auto isSigned = m_config.certificateManager->verifySignatures(wellFormedData);
+    for (size_t j = 0; j < wellFormed.size(); j++) {
+        auto& view = views[wellFormed[j]];
+        if (!isSigned[j]) {
+            NDN_LOG_ERROR("[LedgerImpl::checkSignatureValidityOfRecords] Bad Signature for " << view->getRecordName());
+            view = nullopt;
+            continue;
+        }
+
+        NDN_LOG_TRACE("- Step 3: Check certificate/revocation record format");
+        if (view->getType() == CERTIFICATE_RECORD || view->getType() == REVOCATION_RECORD) {
+            if (!m_config.certificateManager->verifyRecordFormat(view->getRecord())) {
+                NDN_LOG_ERROR("[LedgerImpl::checkSignatureValidityOfRecords] bad certificate/revocation record: " << view->getRecordName());
+                view = nullopt;
+            }
+        } else {
+          NDN_LOG_TRACE("-- Not a certificate/revocation record");
+        }
     }
+    return views;
+}
 
-    NDN_LOG_TRACE("- Step 3: Check rating limit");
+bool
+LedgerImpl::checkSyntaxValidityOfRecord(const RecordView& dataRecord) {
+    NDN_LOG_INFO("[LedgerImpl::checkSyntaxValidityOfRecord] Check the format validity of the record");
+    NDN_LOG_TRACE("- Step 4: Check rating limit");
     auto tp = dataRecord.getGenerationTimestamp();
     if (tp > time::system_clock::now() + m_config.clockSkewTolerance) {
         NDN_LOG_ERROR("[LedgerImpl::checkSyntaxValidityOfRecord] record from too far in the future" << dataRecord.getRecordName());
         return false;
     }
 
-    NDN_LOG_TRACE("- Step 4: Check InterLock Policy");
-    for (const auto &precedingRecordName : dataRecord.getPointersFromHeader()) {
-        NDN_LOG_TRACE("-- Preceding record from " << RecordName(precedingRecordName).getProducerPrefix());
-        if (RecordName(precedingRecordName).getProducerPrefix() == producerID) {
+    NDN_LOG_TRACE("- Step 5: Check InterLock Policy");
+    const auto& producerID = dataRecord.getProducerPrefix();
+    for (const auto &precedingRecordName : dataRecord.getPointers()) {
+        auto precedingProducer = RecordName(precedingRecordName).getProducerPrefix();
+        NDN_LOG_TRACE("-- Preceding record from " << precedingProducer);
+        if (precedingProducer == producerID) {
             NDN_LOG_ERROR("[LedgerImpl::checkSyntaxValidityOfRecord] Preceding record From itself: " << dataRecord.getRecordName());
             return false;
         }
     }
 
-    NDN_LOG_TRACE("- Step 5: Check certificate/revocation record format");
-    if (dataRecord.getType() == CERTIFICATE_RECORD || dataRecord.getType() == REVOCATION_RECORD) {
-        if (!m_config.certificateManager->verifyRecordFormat(dataRecord)) {
-            NDN_LOG_ERROR("[LedgerImpl::checkSyntaxValidityOfRecord] bad certificate/revocation record: " << dataRecord.getRecordName());
-            return false;
-        }
-    } else {
-      NDN_LOG_TRACE("-- Not a certificate/revocation record");
-    }
-
     NDN_LOG_TRACE("- Step 6: Check App Retrieval Check");
-    if (m_onRecordAppRetrievalCheck && !m_onRecordAppRetrievalCheck(data)) {
+    if (m_onRecordAppRetrievalCheck && !m_onRecordAppRetrievalCheck(dataRecord.getData())) {
       NDN_LOG_ERROR("[LedgerImpl::checkSyntaxValidityOfRecord] app retrieval check result: " << dataRecord.getRecordName());
       return false;
     }
@@ -318,16 +498,9 @@ LedgerImpl::checkSyntaxValidityOfRecord(const Data& data) {
 }
 
 bool
-LedgerImpl::checkEndorseValidityOfRecord(const Data& data) {
+LedgerImpl::checkEndorseValidityOfRecord(const Record& dataRecord) {
     NDN_LOG_INFO("[LedgerImpl::checkEndorseValidityOfRecord] Check the reference validity of the record");
-    Record dataRecord;
-    try {
-        // format check
-        dataRecord = Record(data);
-    } catch (const std::exception& e) {
-        NDN_LOG_INFO("-- The Data format is not proper for DLedger record because " << e.what());
-        return false;
-    }
+    const auto& data = *dataRecord.getData();
 
     NDN_LOG_TRACE("- Step 6: Check Revocation");
     if (!m_config.certificateManager->endorseSignature(data)) {
@@ -337,14 +510,16 @@ LedgerImpl::checkEndorseValidityOfRecord(const Data& data) {
 
     NDN_LOG_TRACE("- Step 7: Check Contribution Policy");
     for (const auto& precedingRecordName : dataRecord.getPointersFromHeader()) {
-        if (m_tailRecords.count(precedingRecordName) != 0) {
-            NDN_LOG_TRACE("-- Preceding record " << precedingRecordName << " has weight " << m_tailRecords[precedingRecordName].refSet.size());
-            if (m_tailRecords[precedingRecordName].refSet.size() > m_config.contributionWeight) {
-                NDN_LOG_WARN("[LedgerImpl::checkEndorseValidityOfRecord] Weight too high for " << dataRecord.getRecordName() << " with weight " << m_tailRecords[precedingRecordName].refSet.size());
+        auto precedingHandle = m_recordNames.find(precedingRecordName);
+        if (m_tailRecords.count(precedingHandle) != 0) {
+            size_t weight = getWeight(precedingHandle);
+            NDN_LOG_TRACE("-- Preceding record " << precedingRecordName << " has weight " << weight);
+            if (weight > m_config.contributionWeight) {
+                NDN_LOG_WARN("[LedgerImpl::checkEndorseValidityOfRecord] Weight too high for " << dataRecord.getRecordName() << " with weight " << weight);
                 return false;
             }
         } else {
-            if (m_backend.getRecord(precedingRecordName) != nullptr) {
+            if (findConfirmedRecord(precedingRecordName) != nullptr) {
                 NDN_LOG_WARN("[LedgerImpl::checkEndorseValidityOfRecord] Preceding record " << precedingRecordName << " too deep");
             } else {
                 NDN_LOG_WARN("[LedgerImpl::checkEndorseValidityOfRecord] Preceding record " << precedingRecordName << " Not found");
@@ -377,9 +552,16 @@ LedgerImpl::onLedgerSyncRequest(const Interest& interest)
   if (m_replySyncEventID) m_replySyncEventID.cancel();
 
   const auto& appParam = interest.getApplicationParameters();
-  appParam.parse();
+  try {
+      appParam.parse();
+  } catch (const std::exception& e) {
+      NDN_LOG_ERROR("[LedgerImpl::onLedgerSyncRequest] Bad SYNC parameters because " << e.what());
+      return;
+  }
   bool shouldSendSync = false;
   bool isCertPending = false;
+  bool hasUnknownDigest = false;
+  Name stateName;
   for (const auto& item : appParam.elements()) {
     if (item.type() == tlv::KeyLocator) {
         try {
@@ -399,36 +581,363 @@ LedgerImpl::onLedgerSyncRequest(const Interest& interest)
         continue;
     }
     if (isCertPending) continue;
-    Name recordName(item);
-    if (m_tailRecords.count(recordName) != 0 && m_tailRecords[recordName].refSet.empty()) {
+    if (item.type() == T_TailingDigests) {
+        for (size_t offset = 0; offset + sizeof(uint64_t) <= item.value_size(); offset += sizeof(uint64_t)) {
+            uint64_t digest;
+            std::memcpy(&digest, item.value() + offset, sizeof(digest));
+            auto tailingRecord = m_tailingDigests.find(digest);
+            if (tailingRecord == m_tailingDigests.end()) {
+                hasUnknownDigest = true;
+            }
+            else if (getWeight(tailingRecord->second) != 0) {
+                NDN_LOG_TRACE("--- " << m_recordNames.getName(tailingRecord->second) << " is already endorsed in our Ledger");
+                shouldSendSync = true;
+            }
+        }
+        continue;
+    }
+    if (item.type() == T_SyncStateName) {
+        try {
+            stateName.wireDecode(item.blockFromValue());
+        } catch (const std::exception& e) {
+            NDN_LOG_ERROR("[LedgerImpl::onLedgerSyncRequest] Error on sync state name");
+        }
+        continue;
+    }
+    // full record names, as sent by peers that do not use digests
+    if (item.type() != tlv::Name) continue;
+    Name recordName;
+    try {
+        recordName.wireDecode(item);
+    } catch (const std::exception& e) {
+        NDN_LOG_ERROR("[LedgerImpl::onLedgerSyncRequest] Error on record name");
+        continue;
+    }
+    shouldSendSync = onSyncRecordName(recordName) || shouldSendSync;
+  }
+
+  if (hasUnknownDigest && stateName.size() > 2) {
+      // a peer far ahead of us is caught up with by buckets rather than by walking back the DAG
+      reconcileWith(stateName.getPrefix(-2));
+  }
+  if (hasUnknownDigest && !stateName.empty()) {
+      NDN_LOG_INFO("[LedgerImpl::onLedgerSyncRequest] Fetch sync state " << stateName << " for unknown tailing records");
+      Interest stateInterest(stateName);
+      stateInterest.setCanBePrefix(false);
+      stateInterest.setMustBeFresh(true);
+      m_network.expressInterest(stateInterest,
+                                bind(&LedgerImpl::onSyncStateData, this, _1, _2),
+                                bind(&LedgerImpl::onNack, this, _1, _2), nullptr);
+  }
+  if (shouldSendSync) {
+      scheduleReplySync();
+  }
+}
+
+bool
+LedgerImpl::onSyncRecordName(const Name& recordName)
+{
+    auto recordHandle = m_recordNames.find(recordName);
+    if (m_tailRecords.count(recordHandle) != 0 && getWeight(recordHandle) == 0) {
       NDN_LOG_TRACE("--- " << recordName.toUri() << " is already in our tailing records");
     }
     else if (seenRecord(recordName)) {
       NDN_LOG_TRACE("--- " << recordName.toUri() << " is already in our Ledger but not tailing any more");
-      shouldSendSync = true;
+      return true;
     }
     else {
         NDN_LOG_TRACE("--- " << recordName.toUri() << "is unseen. Fetch");
         //fetch record
         fetchRecord(recordName);
     }
+    return false;
+}
+
+void
+LedgerImpl::scheduleReplySync()
+{
+    NDN_LOG_INFO("[LedgerImpl::onLedgerSyncRequest] send Sync interest so others can fetch new record");
+    if (m_replySyncEventID) m_replySyncEventID.cancel();
+    std::uniform_int_distribution<> dist{10, 200};
+    m_replySyncEventID = m_scheduler.schedule(time::milliseconds(dist(m_randomEngine)), [this] {
+        sendSyncInterest();
+    });
+}
+
+void
+LedgerImpl::onSyncStateRequest(const Interest& interest)
+{
+  for (const auto& state : m_syncStates) {
+    if (state.first != interest.getName()) continue;
+    auto content = makeEmptyBlock(tlv::Content);
+    for (const auto& recordName : state.second) {
+      content.push_back(recordName.wireEncode());
+    }
+    content.parse();
+    Data data(state.first);
+    data.setContent(content);
+    data.setFreshnessPeriod(m_config.syncInterval);
+    try {
+      m_keychain.sign(data, signingByIdentity(m_config.peerPrefix));
+    } catch (const std::exception& e) {
+      NDN_LOG_ERROR("[LedgerImpl::onSyncStateRequest] Signing error: " << e.what());
+      return;
+    }
+    NDN_LOG_INFO("[LedgerImpl::onSyncStateRequest] Reply sync state: " << interest.getName());
+    m_network.put(data);
+    return;
+  }
+  NDN_LOG_ERROR("[LedgerImpl::onSyncStateRequest] Sync state not Found: " << interest.getName());
+}
+
+void
+LedgerImpl::onSyncStateData(const Interest& interest, const Data& data)
+{
+  // the names are only hints: each record fetched through them is verified on its own
+  NDN_LOG_INFO("[LedgerImpl::onSyncStateData] Receive sync state " << data.getName());
+  bool shouldSendSync = false;
+  try {
+    const auto& content = data.getContent();
+    content.parse();
+    for (const auto& item : content.elements()) {
+      shouldSendSync = onSyncRecordName(Name(item)) || shouldSendSync;
+    }
+  } catch (const std::exception& e) {
+    NDN_LOG_ERROR("[LedgerImpl::onSyncStateData] Bad sync state " << data.getName() << " because " << e.what());
+    return;
   }
   if (shouldSendSync) {
-      NDN_LOG_INFO("[LedgerImpl::onLedgerSyncRequest] send Sync interest so others can fetch new record");
-      std::uniform_int_distribution<> dist{10, 200};
-      m_replySyncEventID = m_scheduler.schedule(time::milliseconds(dist(m_randomEngine)), [&] {
-          sendSyncInterest();
-      });
+    scheduleReplySync();
+  }
+}
+
+uint64_t
+LedgerImpl::getBucket(const Name& recordName) const
+{
+  return getBucket(RecordName(recordName).getGenerationTimestamp());
+}
+
+uint64_t
+LedgerImpl::getBucket(const time::system_clock::TimePoint& timestamp) const
+{
+  return time::duration_cast<time::milliseconds>(timestamp.time_since_epoch()).count() /
+         m_config.reconcileBucketWidth.count();
+}
+
+time::system_clock::TimePoint
+LedgerImpl::getBucketStart(uint64_t bucket) const
+{
+  // bucket numbers come from peers and may overflow the time point
+  if (bucket >= getBucket(time::system_clock::TimePoint::max())) {
+    return time::system_clock::TimePoint::max();
+  }
+  return time::system_clock::TimePoint(time::milliseconds(bucket * m_config.reconcileBucketWidth.count()));
+}
+
+SyncBuckets::Summary
+LedgerImpl::summarizeBucket(uint64_t bucket) const
+{
+  SyncBuckets::Summary summary{bucket, 0, 0};
+  std::string cursor;
+  do {
+    for (const auto& recordName : m_backend.listRecordByTime(getBucketStart(bucket), getBucketStart(bucket + 1),
+                                                             BUCKET_SCAN_PAGE_SIZE, cursor)) {
+      summary.count++;
+      summary.digest ^= getTruncatedDigest(recordName);
+    }
+  } while (!cursor.empty());
+  return summary;
+}
+
+void
+LedgerImpl::addToSyncBuckets(const Name& recordName)
+{
+  try {
+    m_syncBuckets.insert(getBucket(recordName), getTruncatedDigest(recordName));
+  } catch (const std::exception& e) {
+    NDN_LOG_ERROR("[LedgerImpl::addToSyncBuckets] Not a record name " << recordName << " because " << e.what());
+  }
+}
+
+void
+LedgerImpl::reconcileWith(const Name& peerPrefix)
+{
+  auto now = time::steady_clock::now();
+  if (now < m_nextReconcileTime || peerPrefix == m_config.peerPrefix) return;
+  m_nextReconcileTime = now + m_config.reconcileInterval;
+
+  Name summaryName = peerPrefix;
+  summaryName.append("SYNC-BUCKETS");
+  NDN_LOG_INFO("[LedgerImpl::reconcileWith] Fetch bucket summaries " << summaryName);
+  Interest summaryInterest(summaryName);
+  summaryInterest.setCanBePrefix(false);
+  summaryInterest.setMustBeFresh(true);
+  m_network.expressInterest(summaryInterest,
+                            bind(&LedgerImpl::onBucketSummaries, this, _1, _2),
+                            bind(&LedgerImpl::onNack, this, _1, _2), nullptr);
+}
+
+void
+LedgerImpl::onBucketRequest(const Interest& interest)
+{
+  // /<peer_prefix>/SYNC-BUCKETS: summaries of the latest buckets
+  // /<peer_prefix>/SYNC-BUCKETS/<bucket>[/<cursor>]: a page of the record names in the bucket,
+  // followed by the cursor of the next page if any
+  const auto& name = interest.getName();
+  size_t bucketRequestSize = m_config.peerPrefix.size() + 2;
+  auto content = makeEmptyBlock(tlv::Content);
+  if (name.size() == m_config.peerPrefix.size() + 1) {
+    m_syncBuckets.advance(getBucket(time::system_clock::now()));
+    for (const auto& summary : m_syncBuckets.getSummaries()) {
+      auto summaryBlock = makeEmptyBlock(T_BucketSummary);
+      summaryBlock.push_back(makeNonNegativeIntegerBlock(T_BucketIndex, summary.bucket));
+      summaryBlock.push_back(makeNonNegativeIntegerBlock(T_BucketCount, summary.count));
+      summaryBlock.push_back(makeNonNegativeIntegerBlock(T_BucketDigest, summary.digest));
+      summaryBlock.encode();
+      content.push_back(summaryBlock);
+    }
+  }
+  else if ((name.size() == bucketRequestSize || name.size() == bucketRequestSize + 1) &&
+           name.get(bucketRequestSize - 1).isNumber()) {
+    auto bucket = name.get(bucketRequestSize - 1).toNumber();
+    std::string cursor;
+    if (name.size() > bucketRequestSize) {
+      const auto& cursorComponent = name.get(bucketRequestSize);
+      cursor.assign(reinterpret_cast<const char*>(cursorComponent.value()), cursorComponent.value_size());
+    }
+    for (const auto& recordName : m_backend.listRecordByTime(getBucketStart(bucket), getBucketStart(bucket + 1),
+                                                             BUCKET_PAGE_SIZE, cursor)) {
+      content.push_back(recordName.wireEncode());
+    }
+    if (!cursor.empty()) {
+      content.push_back(makeBinaryBlock(T_BucketCursor, reinterpret_cast<const uint8_t*>(cursor.data()), cursor.size()));
+    }
+  }
+  else {
+    NDN_LOG_ERROR("[LedgerImpl::onBucketRequest] Bad bucket request: " << name);
+    return;
+  }
+  content.parse();
+
+  Data data(name);
+  data.setContent(content);
+  data.setFreshnessPeriod(m_config.syncInterval);
+  try {
+    m_keychain.sign(data, signingByIdentity(m_config.peerPrefix));
+  } catch (const std::exception& e) {
+    NDN_LOG_ERROR("[LedgerImpl::onBucketRequest] Signing error: " << e.what());
+    return;
+  }
+  NDN_LOG_INFO("[LedgerImpl::onBucketRequest] Reply buckets: " << name);
+  m_network.put(data);
+}
+
+void
+LedgerImpl::onBucketSummaries(const Interest& interest, const Data& data)
+{
+  std::vector<SyncBuckets::Summary> summaries;
+  try {
+    const auto& content = data.getContent();
+    content.parse();
+    for (const auto& item : content.elements()) {
+      // do not summarize more old buckets from the storage than we keep
+      if (summaries.size() >= m_config.maxReconcileBuckets) break;
+      if (item.type() != T_BucketSummary) continue;
+      item.parse();
+      summaries.push_back({readNonNegativeInteger(item.get(T_BucketIndex)),
+                           readNonNegativeInteger(item.get(T_BucketCount)),
+                           readNonNegativeInteger(item.get(T_BucketDigest))});
+    }
+  } catch (const std::exception& e) {
+    NDN_LOG_ERROR("[LedgerImpl::onBucketSummaries] Bad bucket summaries " << data.getName() << " because " << e.what());
+    return;
+  }
+
+  // fetch the differing buckets in parallel
+  m_syncBuckets.advance(getBucket(time::system_clock::now()));
+  auto differentBuckets = m_syncBuckets.findDifferentBuckets(summaries,
+                                                             bind(&LedgerImpl::summarizeBucket, this, _1));
+  for (auto bucket : differentBuckets) {
+    Name bucketName = interest.getName();
+    bucketName.appendNumber(bucket);
+    NDN_LOG_INFO("[LedgerImpl::onBucketSummaries] Fetch differing bucket " << bucketName);
+    fetchBucket(bucketName, "");
+  }
+}
+
+void
+LedgerImpl::fetchBucket(const Name& bucketName, const std::string& cursor)
+{
+  Name pageName = bucketName;
+  if (!cursor.empty()) {
+    pageName.append(reinterpret_cast<const uint8_t*>(cursor.data()), cursor.size());
+  }
+  Interest bucketInterest(pageName);
+  bucketInterest.setCanBePrefix(false);
+  bucketInterest.setMustBeFresh(true);
+  m_network.expressInterest(bucketInterest,
+                            [this, bucketName] (const Interest&, const Data& data) {
+                              onBucketRecords(bucketName, data);
+                            },
+                            bind(&LedgerImpl::onNack, this, _1, _2), nullptr);
+}
+
+void
+LedgerImpl::onBucketRecords(const Name& bucketName, const Data& data)
+{
+  // as with the sync state, the names are only hints and each record is verified on its own
+  std::string cursor;
+  try {
+    const auto& content = data.getContent();
+    content.parse();
+    for (const auto& item : content.elements()) {
+      if (item.type() == T_BucketCursor) {
+        cursor.assign(reinterpret_cast<const char*>(item.value()), item.value_size());
+        continue;
+      }
+      if (item.type() != tlv::Name) continue;
+      try {
+        Name recordName(item);
+        if (!seenRecord(recordName)) {
+          NDN_LOG_TRACE("--- " << recordName.toUri() << " is missing from the bucket. Fetch");
+          fetchRecord(recordName);
+        }
+      } catch (const tlv::Error& e) {
+        NDN_LOG_ERROR("[LedgerImpl::onBucketRecords] Bad record name in bucket " << data.getName() << " because " << e.what());
+      }
+    }
+  } catch (const std::exception& e) {
+    NDN_LOG_ERROR("[LedgerImpl::onBucketRecords] Bad bucket " << data.getName() << " because " << e.what());
+    return;
+  }
+  if (!cursor.empty()) {
+    NDN_LOG_INFO("[LedgerImpl::onBucketRecords] Fetch the next page of bucket " << bucketName);
+    fetchBucket(bucketName, cursor);
   }
 }
 
 void
 LedgerImpl::onRecordRequest(const Interest& interest)
 {
+  if (interest.getName().size() > m_config.peerPrefix.size() &&
+      interest.getName().get(m_config.peerPrefix.size()) == name::Component("SYNC-STATE")) {
+    onSyncStateRequest(interest);
+    return;
+  }
+  if (interest.getName().size() > m_config.peerPrefix.size() &&
+      interest.getName().get(m_config.peerPrefix.size()) == name::Component("BATCH")) {
+    onBatchRequest(interest);
+    return;
+  }
+  if (interest.getName().size() > m_config.peerPrefix.size() &&
+      interest.getName().get(m_config.peerPrefix.size()) == name::Component("SYNC-BUCKETS")) {
+    onBucketRequest(interest);
+    return;
+  }
   auto desiredData = getRecord(interest.getName());
   if (desiredData) {
     NDN_LOG_INFO("[LedgerImpl::onRecordRequest] Reply Data: " << interest.getName());
-    m_network.put(*desiredData->m_data);
+    m_network.put(*desiredData->getData());
   } else {
     NDN_LOG_ERROR("[LedgerImpl::onRecordRequest] Data not Found: " << interest.getName());
   }
@@ -437,122 +946,415 @@ LedgerImpl::onRecordRequest(const Interest& interest)
 void
 LedgerImpl::fetchRecord(const Name& recordName)
 {
-  Interest interestForRecord(recordName);
-  interestForRecord.setCanBePrefix(false);
-  interestForRecord.setMustBeFresh(true);
-  NDN_LOG_INFO("[LedgerImpl::fetchRecord] Fetch the record: " << interestForRecord.getName().toUri());
-  m_network.expressInterest(interestForRecord,
-                            bind(&LedgerImpl::onFetchedRecord, this, _1, _2),
-                            bind(&LedgerImpl::onNack, this, _1, _2),
-                            bind(&LedgerImpl::onTimeout, this, _1));
+  if (m_syncStack.count(m_recordNames.find(recordName)) != 0) {
+    NDN_LOG_TRACE("[LedgerImpl::fetchRecord] Record already fetched and waiting for its ancestors: " << recordName);
+    return;
+  }
+  m_fetcher.fetch(recordName);
 }
 
 void
 LedgerImpl::onFetchedRecord(const Interest& interest, const Data& data)
 {
-  if (seenRecord(data.getFullName())) {
-    NDN_LOG_INFO("[LedgerImpl::onFetchedRecord] Record already exists in the ledger. Ignore " << data.getFullName());
-    return;
-  }
-  for (const auto& stackRecord : m_syncStack) {
-      if (stackRecord.first.getRecordName() == data.getFullName()) {
-          NDN_LOG_INFO("[LedgerImpl::onFetchedRecord] Record in sync stack already. Ignore " << data.getFullName());
-          return;
+  verifyRecords({make_shared<Data>(data)}, bind(&LedgerImpl::onVerifiedRecords, this, _1));
+}
+
+void
+LedgerImpl::verifyRecords(const std::vector<shared_ptr<const Data>>& records, const OnRecordsVerified& onVerified)
+{
+  // records already known need no verification; addToSyncStack checks again once verified
+  std::vector<shared_ptr<const Data>> newRecords;
+  for (const auto& data : records) {
+      const auto& fullName = data->getFullName();
+      if (!seenRecord(fullName) && m_syncStack.count(m_recordNames.find(fullName)) == 0) {
+          newRecords.push_back(data);
       }
   }
-  NDN_LOG_INFO("[LedgerImpl::onFetchedRecord] fetched new record " << data.getFullName());
+  if (newRecords.empty()) {
+      onVerified({});
+      return;
+  }
 
-  try {
-      Record record(data);
-      if (record.getType() == RecordType::GENESIS_RECORD) {
-          throw std::runtime_error("We should not get Genesis record");
+  struct Verification {
+      std::vector<shared_ptr<const Data>> records;
+      std::vector<optional<RecordView>> views; // nullopt for the records that failed
+      size_t remainingChunks;
+  };
+  auto verification = make_shared<Verification>();
+  verification->records = newRecords;
+  verification->views.resize(newRecords.size());
+  // one chunk per thread, so that each verifySignatures call gets a burst to verify with the same keys
+  size_t chunkCount = std::max<size_t>(1, std::min(m_verificationPool.getThreadCount(), newRecords.size()));
+  size_t chunkSize = (newRecords.size() + chunkCount - 1) / chunkCount;
+  verification->remainingChunks = (newRecords.size() + chunkSize - 1) / chunkSize;
+  for (size_t begin = 0; begin < newRecords.size(); begin += chunkSize) {
+      size_t end = std::min(begin + chunkSize, newRecords.size());
+      // the full names are already computed above, so the workers only read the Data
+      m_verificationPool.verify([this, verification, begin, end] {
+          std::vector<shared_ptr<const Data>> chunk(verification->records.begin() + begin,
+                                                    verification->records.begin() + end);
+          auto views = checkSignatureValidityOfRecords(chunk);
+          std::move(views.begin(), views.end(), verification->views.begin() + begin);
+          return true;
+      }, [verification, onVerified] (bool) {
+          if (--verification->remainingChunks > 0) {
+              return;
+          }
+          std::vector<RecordView> verifiedRecords;
+          for (const auto& view : verification->views) {
+              if (view) {
+                  verifiedRecords.push_back(*view);
+              }
+          }
+          onVerified(verifiedRecords);
+      });
+  }
+}
+
+void
+LedgerImpl::onVerifiedRecords(const std::vector<RecordView>& records)
+{
+  removeTimeoutPendingRecords();
+
+  // add all the records first so that the ones fetched together are not fetched again one by one
+  std::vector<NameHandle> handles;
+  for (const auto& record : records) {
+      auto handle = addToSyncStack(record);
+      if (handle != NameTable::INVALID_HANDLE) {
+          handles.push_back(handle);
       }
+  }
+  NDN_LOG_INFO("[LedgerImpl::onVerifiedRecords] " << handles.size() << " new records, SyncStack size " << m_syncStack.size());
 
-      if (!checkSyntaxValidityOfRecord(data)) {
-          throw std::runtime_error("Record Syntax error");
+  for (auto handle : handles) {
+      if (!checkRecordAncestor(handle)) {
+          NDN_LOG_INFO("- Waiting for record to be added");
+      }
+  }
+  for (auto handle : handles) {
+      if (m_syncStack.count(handle) != 0) {
+          fetchMissingAncestors(handle);
       }
+  }
+}
 
-      m_syncStack.emplace_back(record, time::system_clock::now());
-      auto precedingRecordNames = record.getPointersFromHeader();
-      bool allPrecedingRecordsInLedger = true;
-      for (const auto &precedingRecordName : precedingRecordNames) {
-          if (seenRecord(precedingRecordName)) {
-              NDN_LOG_TRACE("- Preceding Record " << precedingRecordName << " already in the ledger");
+NameHandle
+LedgerImpl::addToSyncStack(const RecordView& record)
+{
+  const auto& recordName = record.getRecordName();
+  if (seenRecord(recordName)) {
+    NDN_LOG_INFO("[LedgerImpl::addToSyncStack] Record already exists in the ledger. Ignore " << recordName);
+    return NameTable::INVALID_HANDLE;
+  }
+  if (m_syncStack.count(m_recordNames.find(recordName)) != 0) {
+    NDN_LOG_INFO("[LedgerImpl::addToSyncStack] Record in sync stack already. Ignore " << recordName);
+    return NameTable::INVALID_HANDLE;
+  }
+  NDN_LOG_INFO("[LedgerImpl::addToSyncStack] fetched new record " << recordName);
+
+  if (record.getType() == RecordType::GENESIS_RECORD) {
+      NDN_LOG_ERROR("- We should not get Genesis record " << recordName);
+      return NameTable::INVALID_HANDLE;
+  }
+  if (!checkSyntaxValidityOfRecord(record)) {
+      NDN_LOG_ERROR("- Record Syntax error in " << recordName);
+      return NameTable::INVALID_HANDLE;
+  }
+
+  auto addedTime = time::system_clock::now();
+  auto handle = m_recordNames.acquire(recordName);
+  m_syncStack.emplace(handle, PendingRecord{record, addedTime, {}});
+  m_syncStackDeadlines.emplace(addedTime, handle);
+  return handle;
+}
+
+void
+LedgerImpl::fetchMissingAncestors(NameHandle handle)
+{
+  const auto& pendingRecord = m_syncStack.at(handle).record;
+  std::vector<Name> missingAncestors;
+  for (const auto &precedingRecordName : pendingRecord.getPointers()) {
+      if (seenRecord(precedingRecordName)) {
+          NDN_LOG_TRACE("- Preceding Record " << precedingRecordName << " already in the ledger");
+      } else {
+          missingAncestors.push_back(precedingRecordName);
+      }
+  }
+  if (pendingRecord.getType() == CERTIFICATE_RECORD) {
+      NDN_LOG_INFO("- Checking previous cert record");
+      for (const auto &prevCertName : pendingRecord.getPrevCertificates()) {
+          if (prevCertName.empty()) continue;
+          if (seenRecord(prevCertName)) {
+              NDN_LOG_TRACE("- Preceding Cert Record " << prevCertName << " already in the ledger");
           } else {
-              allPrecedingRecordsInLedger = false;
-              fetchRecord(precedingRecordName);
+              NDN_LOG_TRACE("- Preceding Cert Record " << prevCertName << " unseen");
+              missingAncestors.push_back(prevCertName);
           }
       }
-      if (record.getType() == CERTIFICATE_RECORD) {
-          NDN_LOG_INFO("- Checking previous cert record");
-          CertificateRecord certRecord(record);
-          for (const auto &prevCertName : certRecord.getPrevCertificates()) {
-              if (prevCertName.empty()) continue;
-              if (seenRecord(prevCertName)) {
-                  NDN_LOG_TRACE("- Preceding Cert Record " << prevCertName << " already in the ledger");
-              } else {
-                  NDN_LOG_TRACE("- Preceding Cert Record " << prevCertName << " unseen");
-                  allPrecedingRecordsInLedger = false;
-                  fetchRecord(prevCertName);
-              }
-          }
+  }
+  // ancestors already waiting in the sync stack need no new request
+  missingAncestors.erase(std::remove_if(missingAncestors.begin(), missingAncestors.end(), [this] (const Name& ancestor) {
+      return m_syncStack.count(m_recordNames.find(ancestor)) != 0;
+  }), missingAncestors.end());
+  if (missingAncestors.empty()) {
+      return;
+  }
+
+  bool isAllFetching = std::all_of(missingAncestors.begin(), missingAncestors.end(), [this] (const Name& ancestor) {
+      return m_fetcher.isFetching(ancestor);
+  });
+  if (m_config.batchFetchDepth == 0 || m_pendingBatchCount >= m_config.maxPendingBatches || isAllFetching) {
+      for (const auto& ancestor : missingAncestors) {
+          fetchRecord(ancestor);
       }
+      return;
+  }
 
-      if (!allPrecedingRecordsInLedger) {
-          NDN_LOG_INFO("- Waiting for record to be added");
-          return;
+  // the producer of a record holds all its ancestors, so ask it for them at once
+  const auto& recordName = pendingRecord.getRecordName();
+  Name batchName = RecordBatch::makeRequestName(pendingRecord.getProducerPrefix(), m_config.batchFetchDepth, recordName);
+  NDN_LOG_INFO("[LedgerImpl::fetchMissingAncestors] Fetch ancestors of " << recordName << " in a batch");
+  Interest batchInterest(batchName);
+  batchInterest.setMustBeFresh(true);
+  m_pendingBatchCount++;
+  auto fetcher = util::SegmentFetcher::start(m_network, batchInterest, m_batchValidator);
+  fetcher->onComplete.connect([this, missingAncestors] (ConstBufferPtr content) {
+      m_pendingBatchCount--;
+      onFetchedBatch(content, missingAncestors);
+  });
+  fetcher->onError.connect([this, missingAncestors, batchName] (uint32_t code, const std::string& msg) {
+      m_pendingBatchCount--;
+      NDN_LOG_ERROR("[LedgerImpl::fetchMissingAncestors] Batch " << batchName << " failed: " << msg);
+      fetchUnseenRecords(missingAncestors);
+  });
+}
+
+void
+LedgerImpl::fetchUnseenRecords(const std::vector<Name>& recordNames)
+{
+  for (const auto& recordName : recordNames) {
+      if (!seenRecord(recordName)) {
+          fetchRecord(recordName);
       }
+  }
+}
 
+void
+LedgerImpl::onFetchedBatch(const ConstBufferPtr& content, const std::vector<Name>& requestedRecords)
+{
+  std::vector<shared_ptr<const Data>> records;
+  try {
+      records = RecordBatch::parse(content);
   } catch (const std::exception& e) {
-      NDN_LOG_ERROR("- The Data format of " << data.getFullName() << " is not proper for DLedger record because " << e.what());
+      NDN_LOG_ERROR("[LedgerImpl::onFetchedBatch] Bad batch because " << e.what());
+  }
+  NDN_LOG_INFO("[LedgerImpl::onFetchedBatch] " << records.size() << " records in the batch");
+
+  if (records.empty()) {
+      fetchUnseenRecords(requestedRecords);
       return;
   }
+  verifyRecords(records, [this, requestedRecords] (const std::vector<RecordView>& verifiedRecords) {
+      onVerifiedRecords(verifiedRecords);
+      // the requested records missing from the batch are fetched one by one
+      fetchUnseenRecords(requestedRecords);
+  });
+}
 
-  int stackSize = INT_MAX;
-  while (stackSize != m_syncStack.size()) {
-      stackSize = m_syncStack.size();
-      NDN_LOG_INFO("[LedgerImpl::onFetchedRecord] SyncStack size " << m_syncStack.size());
-      for (auto it = m_syncStack.begin(); it != m_syncStack.end();) {
-          if (checkRecordAncestor(it->first)) {
-              it = m_syncStack.erase(it);
-          } else if(time::abs(time::system_clock::now() - it->second) > m_config.ancestorFetchTimeout){
-              NDN_LOG_WARN("[LedgerImpl::onFetchedRecord] Timeout on fetching ancestor for " << it->first.getRecordName().toUri());
-              it = m_syncStack.erase(it);
-          } else {
-              // else, some preceding records are not yet fetched
-              it++;
-          }
+void
+LedgerImpl::onBatchRequest(const Interest& interest)
+{
+  // /<peer_prefix>/BATCH/<depth>/<record name>[/<version>/<segment>]
+  const auto& interestName = interest.getName();
+  Name requestName;
+  Name recordName;
+  size_t depth = 0;
+  try {
+    requestName = RecordBatch::parseRequestName(interestName, m_config.peerPrefix.size(), recordName, depth);
+  } catch (const std::exception& e) {
+    NDN_LOG_ERROR("[LedgerImpl::onBatchRequest] Bad batch request: " << interestName << " because " << e.what());
+    return;
+  }
+  size_t requestSize = requestName.size();
+  auto response = std::find_if(m_batchResponses.begin(), m_batchResponses.end(), [&] (const auto& item) {
+    return item.first == requestName;
+  });
+  if (response == m_batchResponses.end()) {
+    auto segments = makeBatch(requestName, recordName, depth);
+    if (segments.empty()) {
+      NDN_LOG_ERROR("[LedgerImpl::onBatchRequest] Record not Found: " << interestName);
+      return;
+    }
+    m_batchResponses.emplace_back(requestName, std::move(segments));
+    while (m_batchResponses.size() > MAX_KEPT_BATCHES) {
+      m_batchResponses.pop_front();
+    }
+    response = std::prev(m_batchResponses.end());
+  }
+
+  const auto& segments = response->second;
+  uint64_t segment = 0;
+  if (interestName.size() > requestSize && interestName.get(-1).isSegment()) {
+    segment = interestName.get(-1).toSegment();
+  }
+  if (segment >= segments.size()) {
+    NDN_LOG_ERROR("[LedgerImpl::onBatchRequest] Segment not Found: " << interestName);
+    return;
+  }
+  NDN_LOG_INFO("[LedgerImpl::onBatchRequest] Reply batch segment: " << segments[segment]->getName());
+  m_network.put(*segments[segment]);
+}
+
+std::vector<shared_ptr<Data>>
+LedgerImpl::makeBatch(const Name& requestName, const Name& recordName, size_t depth)
+{
+  std::vector<shared_ptr<Data>> segments;
+  auto record = getRecord(recordName);
+  if (!record) {
+    return segments;
+  }
+
+  // breadth-first over the record pointers, up to the depth or the size limit
+  std::vector<Block> batch;
+  size_t batchSize = 0;
+  bool isFull = false;
+  std::set<Name> visited{recordName};
+  std::vector<Record> layer{*record};
+  for (size_t level = 0; level < depth && !layer.empty() && !isFull; level++) {
+    std::vector<Record> nextLayer;
+    for (const auto& current : layer) {
+      if (isFull) break;
+      for (const auto& pointer : current.getPointersFromHeader()) {
+        if (!visited.insert(pointer).second) continue;
+        auto ancestor = getRecord(pointer);
+        if (!ancestor || ancestor->getType() == GENESIS_RECORD) continue;
+        const auto& wire = ancestor->getData()->wireEncode();
+        if (batchSize + wire.size() > MAX_BATCH_SEGMENTS * BATCH_SEGMENT_SIZE) {
+          isFull = true;
+          break;
+        }
+        batchSize += wire.size();
+        batch.push_back(wire);
+        nextLayer.push_back(std::move(*ancestor));
       }
+    }
+    layer = std::move(nextLayer);
   }
+  // the records carry their own signatures, so the segments are only protected by a digest
+  segments = RecordBatch::makeSegments(requestName, batch, BATCH_SEGMENT_SIZE);
+  for (const auto& segment : segments) {
+    segment->setFreshnessPeriod(m_config.syncInterval);
+    m_keychain.sign(*segment, signingWithSha256());
+  }
+  return segments;
 }
 
 bool
-LedgerImpl::checkRecordAncestor(const Record &record) {
-    bool readyToAdd = true;
-    for (const auto& precedingRecordName : record.getPointersFromHeader()) {
-        if (!hasRecord(precedingRecordName.toUri())) {
-            readyToAdd = false;
-            break;
+LedgerImpl::checkRecordAncestor(NameHandle handle) {
+    auto pending = m_syncStack.find(handle);
+    if (pending == m_syncStack.end()) {
+        return true;
+    }
+    const auto& record = pending->second.record;
+    std::vector<Name> missingAncestors;
+    for (const auto& precedingRecordName : record.getPointers()) {
+        if (!hasRecord(precedingRecordName)) {
+            missingAncestors.push_back(precedingRecordName);
         }
     }
     if (record.getType() == CERTIFICATE_RECORD) {
-        CertificateRecord certRecord(record);
-        for (const auto &prevCertName : certRecord.getPrevCertificates()) {
+        for (const auto &prevCertName : record.getPrevCertificates()) {
             if (!prevCertName.empty() && !seenRecord(prevCertName)) {
-                readyToAdd = false;
+                missingAncestors.push_back(prevCertName);
             }
         }
     }
-    if (readyToAdd) {
-        addToTailingRecord(record, checkEndorseValidityOfRecord(*(record.m_data)));
-        return true;
+
+    stopWaitingOnAncestors(handle);
+    if (!missingAncestors.empty()) {
+        for (const auto& ancestor : missingAncestors) {
+            auto ancestorHandle = m_recordNames.acquire(ancestor);
+            m_pendingByAncestor[ancestorHandle].push_back(handle);
+            pending->second.waitingOn.push_back(ancestorHandle);
+        }
+        return false;
+    }
+
+    RecordView readyRecord = std::move(pending->second.record);
+    m_syncStack.erase(pending);
+    addToTailingRecord(readyRecord.getRecord(), checkEndorseValidityOfRecord(readyRecord.getRecord()));
+    // released after the record is added so that the handle stays the same for records waiting on it
+    m_recordNames.release(handle);
+    return true;
+}
+
+void
+LedgerImpl::processAvailableRecords()
+{
+    if (m_isProcessingAvailableRecords) return;
+    m_isProcessingAvailableRecords = true;
+    while (!m_availableRecords.empty()) {
+        auto available = m_availableRecords.back();
+        m_availableRecords.pop_back();
+        auto waiting = m_pendingByAncestor.find(available);
+        if (waiting == m_pendingByAncestor.end()) continue;
+        auto waitingRecords = std::move(waiting->second);
+        m_pendingByAncestor.erase(waiting);
+
+        for (const auto& waitingRecord : waitingRecords) {
+            m_recordNames.release(available);
+            auto pending = m_syncStack.find(waitingRecord);
+            if (pending == m_syncStack.end()) continue;
+            auto& waitingOn = pending->second.waitingOn;
+            auto it = std::find(waitingOn.begin(), waitingOn.end(), available);
+            if (it != waitingOn.end()) waitingOn.erase(it);
+            // records still missing other ancestors are checked again when those arrive
+            if (waitingOn.empty()) {
+                checkRecordAncestor(waitingRecord);
+            }
+        }
+    }
+    m_isProcessingAvailableRecords = false;
+}
+
+void
+LedgerImpl::stopWaitingOnAncestors(NameHandle handle)
+{
+    auto pending = m_syncStack.find(handle);
+    if (pending == m_syncStack.end()) return;
+    for (const auto& ancestor : pending->second.waitingOn) {
+        auto waiting = m_pendingByAncestor.find(ancestor);
+        if (waiting != m_pendingByAncestor.end()) {
+            auto& waitingRecords = waiting->second;
+            auto it = std::find(waitingRecords.begin(), waitingRecords.end(), handle);
+            if (it != waitingRecords.end()) waitingRecords.erase(it);
+            if (waitingRecords.empty()) m_pendingByAncestor.erase(waiting);
+        }
+        m_recordNames.release(ancestor);
+    }
+    pending->second.waitingOn.clear();
+}
+
+void
+LedgerImpl::removeTimeoutPendingRecords()
+{
+    auto timeBefore = time::system_clock::now() - m_config.ancestorFetchTimeout;
+    while (!m_syncStackDeadlines.empty() && m_syncStackDeadlines.top().first < timeBefore) {
+        auto entry = m_syncStackDeadlines.top();
+        m_syncStackDeadlines.pop();
+        auto pending = m_syncStack.find(entry.second);
+        // skip records that already left the sync stack (the handle may have been reused)
+        if (pending == m_syncStack.end() || pending->second.addedTime != entry.first) continue;
+        NDN_LOG_WARN("[LedgerImpl::removeTimeoutPendingRecords] Timeout on fetching ancestor for " << pending->second.record.getRecordName().toUri());
+        stopWaitingOnAncestors(entry.second);
+        m_syncStack.erase(pending);
+        m_recordNames.release(entry.second);
     }
-    return false;
 }
 
 void
 LedgerImpl::addToTailingRecord(const Record& record, bool endorseVerified) {
-    if (m_tailRecords.count(record.getRecordName()) != 0) {
+    if (findTailingRecord(record.getRecordName()) != nullptr) {
         NDN_LOG_INFO("[LedgerImpl::addToTailingRecord] Repeated add record: " << record.getRecordName());
         return;
     }
@@ -562,8 +1364,8 @@ LedgerImpl::addToTailingRecord(const Record& record, bool endorseVerified) {
     bool refVerified = endorseVerified;
     if (endorseVerified) {
         for (const auto &precedingRecord : record.getPointersFromHeader()) {
-            if (m_tailRecords.count(precedingRecord) != 0 &&
-                !m_tailRecords[precedingRecord].parentEndorseVerified) {
+            auto precedingState = findTailingRecord(precedingRecord);
+            if (precedingState != nullptr && !precedingState->parentEndorseVerified) {
                 refVerified = false;
                 break;
             }
@@ -571,78 +1373,95 @@ LedgerImpl::addToTailingRecord(const Record& record, bool endorseVerified) {
     }
 
     //add record to tailing record
-    m_tailRecords[record.getRecordName()] = TailingRecordState{refVerified, std::set<Name>(), endorseVerified,
-                                                               record, time::system_clock::now()};
+    auto handle = m_recordNames.acquire(record.getRecordName());
+    std::vector<NameHandle> pointers;
+    for (const auto &precedingRecord : record.getPointersFromHeader()) {
+        auto precedingHandle = m_recordNames.find(precedingRecord);
+        if (precedingHandle != NameTable::INVALID_HANDLE) {
+            pointers.push_back(precedingHandle);
+        }
+    }
+    m_weightEngine.addRecord(handle, getProducerHandle(record.getProducerPrefix()), pointers);
+    m_tailingDigests[getTruncatedDigest(record.getRecordName())] = handle;
+    auto addedTime = time::system_clock::now();
+    m_tailRecords[handle] = TailingRecordState{refVerified, endorseVerified, record, addedTime};
+    m_expiryQueue.emplace(addedTime, handle);
+    if (!m_expiryEventID) scheduleTimeoutRemoval();
+    m_availableRecords.push_back(handle);
 
     //update weight of the system
-    std::stack<Name> stack;
-    std::set<Name> updatedRecords;
-
     //only count the weight if the record is valid for all policies
+    std::vector<NameHandle> updatedRecords;
     if (endorseVerified) {
-        stack.push(record.getRecordName());
-    }
-    while (!stack.empty()) {
-        RecordName currentRecordName(stack.top());
-        stack.pop();
-        if (currentRecordName.getRecordType() == GENESIS_RECORD) continue;
-        Record currentRecord = *getRecord(currentRecordName);
-        auto precedingRecordList = currentRecord.getPointersFromHeader();
-        for (const auto &precedingRecord : precedingRecordList) {
-            if (RecordName(precedingRecord).getProducerPrefix() == record.getProducerPrefix()) continue;
-            if (m_tailRecords.count(precedingRecord) != 0 &&
-                m_tailRecords[precedingRecord].refSet.insert(record.getProducerPrefix()).second) {
-                stack.push(precedingRecord);
-                updatedRecords.insert(precedingRecord);
-                NDN_LOG_TRACE("[LedgerImpl::addToTailingRecord]" << record.getProducerPrefix() << " confirms " << precedingRecord.toUri());
-            }
-        }
+        updatedRecords = m_weightEngine.propagateWeight(handle);
     }
 
     //remove deep records
     int removeWeight = max(m_config.contributionWeight + 1, m_config.confirmWeight);
-    bool referenceNeedUpdate = false;
+    // children of records that just became parentEndorseVerified; collected before the parents are removed
+    std::vector<NameHandle> referenceWorklist;
     for (const auto & updatedRecord : updatedRecords) {
+        size_t weight = getWeight(updatedRecord);
+        NDN_LOG_TRACE("[LedgerImpl::addToTailingRecord]" << record.getProducerPrefix() << " confirms " << m_recordNames.getName(updatedRecord));
         auto& tailingState = m_tailRecords[updatedRecord];
-        if (tailingState.refSet.size() == m_config.confirmWeight) {
-            NDN_LOG_INFO("[LedgerImpl::addToTailingRecord]" << updatedRecord.toUri()  << " is confirmed");
+        if (weight == m_config.confirmWeight) {
+            NDN_LOG_INFO("[LedgerImpl::addToTailingRecord]" << m_recordNames.getName(updatedRecord) << " is confirmed");
             if (!tailingState.parentEndorseVerified) {
                 tailingState.parentEndorseVerified = true;
-                referenceNeedUpdate = true;
+                m_availableRecords.push_back(updatedRecord);
+                const auto& children = m_weightEngine.getChildren(updatedRecord);
+                referenceWorklist.insert(referenceWorklist.end(), children.begin(), children.end());
             }
-            onRecordConfirmed(*getRecord(updatedRecord));
+            onRecordConfirmed(tailingState.record);
         }
-        if (tailingState.refSet.size() >= removeWeight) {
-            m_tailRecords.erase(updatedRecord);
+        if (weight >= removeWeight) {
+            removeTailingRecord(updatedRecord);
         }
     }
 
-    //update reference policy
-    while (referenceNeedUpdate) {
-        referenceNeedUpdate = false;
-        for (auto &r : m_tailRecords) {
-            if (!r.second.parentEndorseVerified && r.second.recordEndorseVerified) {
-                bool referenceVerified = true;
-                Record currentRecord(*getRecord(r.first));
-                for (const auto &precedingRecord : currentRecord.getPointersFromHeader()) {
-                    if ((m_tailRecords.count(precedingRecord) &&
-                            m_tailRecords[precedingRecord].refSet.size() < m_config.confirmWeight) &&
-                        !m_tailRecords[precedingRecord].parentEndorseVerified) {
-                        referenceVerified = false;
-                    }
-                }
+    //update reference policy, only re-evaluating the children of newly verified records
+    while (!referenceWorklist.empty()) {
+        auto current = referenceWorklist.back();
+        referenceWorklist.pop_back();
+        auto currentState = m_tailRecords.find(current);
+        if (currentState == m_tailRecords.end() ||
+            currentState->second.parentEndorseVerified || !currentState->second.recordEndorseVerified) {
+            continue;
+        }
 
-                if (referenceVerified) {
-                    r.second.parentEndorseVerified = referenceVerified;
-                    referenceNeedUpdate = true;
-                }
+        bool referenceVerified = true;
+        for (const auto &precedingRecord : m_weightEngine.getParents(current)) {
+            auto precedingState = m_tailRecords.find(precedingRecord);
+            if (precedingState != m_tailRecords.end() &&
+                getWeight(precedingRecord) < m_config.confirmWeight &&
+                !precedingState->second.parentEndorseVerified) {
+                referenceVerified = false;
+                break;
             }
         }
+
+        if (referenceVerified) {
+            currentState->second.parentEndorseVerified = true;
+            m_availableRecords.push_back(current);
+            const auto& children = m_weightEngine.getChildren(current);
+            referenceWorklist.insert(referenceWorklist.end(), children.begin(), children.end());
+        }
     }
 
-    removeTimeoutRecords();
+    dumpList();
 
-    dumpList(m_tailRecords);
+    // records in the sync stack waiting on the new or newly verified records
+    processAvailableRecords();
+}
+
+void
+LedgerImpl::flushBackend()
+{
+    if (!m_backend.flush()) {
+        NDN_LOG_ERROR("[LedgerImpl::flushBackend] Unable to write the confirmed records, retry in "
+                      << m_config.backendFlushInterval.count() << " ms");
+        m_flushEventID = m_scheduler.schedule(m_config.backendFlushInterval, [this] { flushBackend(); });
+    }
 }
 
 void
@@ -650,14 +1469,28 @@ LedgerImpl::onRecordConfirmed(const Record &record){
     NDN_LOG_INFO("[LedgerImpl::onRecordConfirmed] accept record" << record.getRecordName());
 
     //add to backend database
-    m_backend.putRecord(record.m_data);
+    if (!m_backend.putRecord(record.getData())) {
+        NDN_LOG_ERROR("[LedgerImpl::onRecordConfirmed] Unable to write to the backend, the write is kept pending");
+    }
+    m_recordCache.insert(record.getRecordName(), record);
+    addToSyncBuckets(record.getRecordName());
+    // records confirmed together are committed in one write
+    if (m_backend.hasPendingWrites() && !m_flushEventID) {
+        m_flushEventID = m_scheduler.schedule(m_config.backendFlushInterval, [this] { flushBackend(); });
+    }
 
     if (record.getType() == RecordType::CERTIFICATE_RECORD) {
         try {
             auto certRecord = CertificateRecord(record);
-            m_lastCertRecords.push_back(certRecord.getRecordName());
+            m_lastCertRecords.push_back(m_recordNames.acquire(certRecord.getRecordName()));
             for (const auto &c : certRecord.getPrevCertificates()) {
-                m_lastCertRecords.remove(c);
+                auto prevHandle = m_recordNames.find(c);
+                if (prevHandle == NameTable::INVALID_HANDLE) continue;
+                auto it = std::find(m_lastCertRecords.begin(), m_lastCertRecords.end(), prevHandle);
+                if (it != m_lastCertRecords.end()) {
+                    m_lastCertRecords.erase(it);
+                    m_recordNames.release(prevHandle);
+                }
             }
         } catch (const std::exception &e) {
             NDN_LOG_ERROR("[LedgerImpl::onRecordConfirmed] Bad certificate record format for " << record.getRecordName());
@@ -677,32 +1510,43 @@ LedgerImpl::onRecordConfirmed(const Record &record){
 void
 LedgerImpl::removeTimeoutRecords()
 {
-  std::set<Name> timeoutList;
+  std::vector<NameHandle> timeoutList;
   auto timeBefore = time::system_clock::now() - m_config.blockConfirmationTimeout;
-  for (const auto& record : m_tailRecords) {
-    if (record.second.refSet.size() < m_config.confirmWeight && //unconfirmed
-        record.second.addedTime < timeBefore) {
-      timeoutList.insert(record.first);
+  while (!m_expiryQueue.empty() && m_expiryQueue.top().first <= timeBefore) {
+    auto entry = m_expiryQueue.top();
+    m_expiryQueue.pop();
+    auto it = m_tailRecords.find(entry.second);
+    // skip records that already left the tailing set (the handle may have been reused)
+    if (it == m_tailRecords.end() || it->second.addedTime != entry.first) continue;
+    if (getWeight(entry.second) < m_config.confirmWeight) { //unconfirmed
+      timeoutList.push_back(entry.second);
     }
   }
 
+  // children of a timeout record are removed as well
   while (!timeoutList.empty()) {
-    for (const auto& i : timeoutList) {
-      m_tailRecords.erase(i);
-      NDN_LOG_INFO("[LedgerImpl::removeTimeoutRecords] remove timeout record " << i);
-    }
-    std::set<Name> childrenList;
-    for (const auto& record : m_tailRecords) {
-      for (const auto& parent : record.second.record.getPointersFromHeader()) {
-        if (timeoutList.count(parent)) { // if parent in the set
-          childrenList.insert(record.first); //child should be removed
-        }
-      }
-    }
-    timeoutList.swap(childrenList);
+    auto current = timeoutList.back();
+    timeoutList.pop_back();
+    if (m_tailRecords.count(current) == 0) continue;
+    const auto& children = m_weightEngine.getChildren(current);
+    timeoutList.insert(timeoutList.end(), children.begin(), children.end());
+    NDN_LOG_INFO("[LedgerImpl::removeTimeoutRecords] remove timeout record " << m_recordNames.getName(current));
+    removeTailingRecord(current);
   }
 }
 
+void
+LedgerImpl::scheduleTimeoutRemoval()
+{
+  if (m_expiryQueue.empty()) return;
+  auto delay = m_expiryQueue.top().first + m_config.blockConfirmationTimeout - time::system_clock::now();
+  if (delay < time::nanoseconds::zero()) delay = time::nanoseconds::zero();
+  m_expiryEventID = m_scheduler.schedule(delay, [this] {
+    removeTimeoutRecords();
+    scheduleTimeoutRemoval();
+  });
+}
+
 std::unique_ptr<Ledger>
 Ledger::initLedger(const Config& config, security::KeyChain& keychain, Face& face)
 {
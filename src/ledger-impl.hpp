@@ -5,14 +5,23 @@
 #include "dledger/record.hpp"
 #include "dledger/config.hpp"
 #include "backend.hpp"
+#include "lru-cache.hpp"
+#include "name-table.hpp"
+#include "record-fetcher.hpp"
+#include "record-view.hpp"
+#include "sync-buckets.hpp"
+#include "verification-pool.hpp"
+#include "weight-engine.hpp"
 #include <ndn-cxx/security/certificate.hpp>
 #include <ndn-cxx/security/key-chain.hpp>
 #include <ndn-cxx/face.hpp>
 #include <ndn-cxx/util/scheduler.hpp>
 #include <boost/asio/io_service.hpp>
 #include <ndn-cxx/util/io.hpp>
+#include <ndn-cxx/security/validator-null.hpp>
 #include <ndn-cxx/util/scheduler.hpp>
-#include <stack>
+#include <deque>
+#include <queue>
 #include <random>
 
 
@@ -38,46 +47,194 @@ public:
   std::list<Name>
   listRecord(const std::string& prefix) const override;
 
+  std::list<Name>
+  listRecord(const std::string& prefix, size_t pageSize, std::string& cursor) const override;
+
+  std::list<Name>
+  listRecordByType(RecordType type, const time::system_clock::TimePoint& since,
+                   const time::system_clock::TimePoint& until) const override;
+
+  std::list<Name>
+  listRecordByProducer(const std::string& producerPrefix, const time::system_clock::TimePoint& since,
+                       const time::system_clock::TimePoint& until) const override;
+
+  std::list<Name>
+  listRecordByTime(const time::system_clock::TimePoint& since,
+                   const time::system_clock::TimePoint& until) const override;
+
 private:
+  /**
+   * removes the tailing records whose ancestors are not verified yet, as getRecord does not return them
+   */
+  void
+  removeUnverifiedRecords(std::list<Name>& recordNames) const;
+
   optional<Record>
   getRecord(const Name& recordName) const;
 
+  bool
+  hasRecord(const Name& recordName) const;
+
   bool
   seenRecord(const Name& recordName) const;
 
-  void
-  onNack(const Interest&, const lp::Nack& nack);
+  /**
+   * @return the record accepted into the backend, served from the record cache when possible;
+   *         the pointer is valid until the next cache insertion
+   */
+  const Record*
+  findConfirmedRecord(const Name& recordName) const;
 
   void
-  onTimeout(const Interest& interest);
+  onNack(const Interest&, const lp::Nack& nack);
 
   // the function to generate a sync Interest and send it out
   // should be invoked periodically or on solicit request
   ReturnCode
   sendSyncInterest();
 
+  /**
+   * checks the record formats, the signatures and the certificate/revocation record formats,
+   * which do not depend on the ledger state; runs on the verification threads
+   * @return the parsed records in the order of the records, or nullopt for those that failed
+   */
+  std::vector<optional<RecordView>>
+  checkSignatureValidityOfRecords(const std::vector<shared_ptr<const Data>>& records) const;
   bool
-  checkSyntaxValidityOfRecord(const Data& data);
+  checkSyntaxValidityOfRecord(const RecordView& dataRecord);
   bool
-  checkEndorseValidityOfRecord(const Data& data);
+  checkEndorseValidityOfRecord(const Record& dataRecord);
 
   // Interest format:
   // /<multicast_prefix>/SYNC
-  // Parameters: A list of tailing record names
+  // Parameters: the last cert records, the truncated digests of the tailing records,
+  // and the name of the sync state listing their full names
   void
   onLedgerSyncRequest(const Interest& interest);
 
+  /**
+   * handles a tailing record name carried by a sync Interest or a sync state
+   * @return true if the record is no longer tailing here and a SYNC should be sent back
+   */
+  bool
+  onSyncRecordName(const Name& recordName);
+
+  void
+  scheduleReplySync();
+
   // Interest format:
-  // record full name
+  // record full name, or /<peer_prefix>/SYNC-STATE/<digest>
   void
   onRecordRequest(const Interest& interest);
 
+  void
+  onSyncStateRequest(const Interest& interest);
+  void
+  onSyncStateData(const Interest& interest, const Data& data);
+
+  // Interest format:
+  // /<peer_prefix>/SYNC-BUCKETS[/<bucket>[/<cursor>]]
+  void
+  onBucketRequest(const Interest& interest);
+
+  /**
+   * fetches the bucket summaries of a peer and then the record names in the buckets we differ in,
+   * at most once per reconcileInterval
+   */
+  void
+  reconcileWith(const Name& peerPrefix);
+  void
+  onBucketSummaries(const Interest& interest, const Data& data);
+  /**
+   * fetches the names of a differing bucket page by page
+   * @param cursor the cursor of the page, or empty for the first page
+   */
+  void
+  fetchBucket(const Name& bucketName, const std::string& cursor);
+  void
+  onBucketRecords(const Name& bucketName, const Data& data);
+
+  /**
+   * @return the bucket of the record generation time
+   */
+  uint64_t
+  getBucket(const Name& recordName) const;
+  uint64_t
+  getBucket(const time::system_clock::TimePoint& timestamp) const;
+
+  /**
+   * @return the start of the bucket time range, or TimePoint::max() if the bucket is out of range
+   */
+  time::system_clock::TimePoint
+  getBucketStart(uint64_t bucket) const;
+
+  /**
+   * @return the summary of the bucket computed from the time index of the storage
+   */
+  SyncBuckets::Summary
+  summarizeBucket(uint64_t bucket) const;
+
+  void
+  addToSyncBuckets(const Name& recordName);
+
+  /**
+   * @return the first 8 bytes of the implicit digest of the record full name
+   */
+  static uint64_t
+  getTruncatedDigest(const Name& recordName);
+
   // Zhiyi's temp function
+  // requests the record through the fetcher unless it is already waiting in the sync stack
   void
   fetchRecord(const Name& dataName);
   void
   onFetchedRecord(const Interest& interest, const Data& data);
 
+  using OnRecordsVerified = function<void(const std::vector<RecordView>&)>;
+
+  /**
+   * checks the signatures of the fetched records that are new to the ledger on the verification pool
+   * @param onVerified called on the Face thread with the records that passed, parsed, in the given order
+   */
+  void
+  verifyRecords(const std::vector<shared_ptr<const Data>>& records, const OnRecordsVerified& onVerified);
+
+  /**
+   * adds the verified records to the sync stack and requests their missing ancestors
+   */
+  void
+  onVerifiedRecords(const std::vector<RecordView>& records);
+
+  /**
+   * checks a verified record against the ledger state and puts it into the sync stack
+   * @return the handle of the record, or INVALID_HANDLE if the record is seen or invalid
+   */
+  NameHandle
+  addToSyncStack(const RecordView& record);
+
+  /**
+   * requests the unseen ancestors of a record in the sync stack, in a batch from the record producer
+   * when a batch slot is free and one by one otherwise
+   */
+  void
+  fetchMissingAncestors(NameHandle record);
+  void
+  fetchUnseenRecords(const std::vector<Name>& recordNames);
+  /**
+   * @param requestedRecords the ancestors the batch was requested for; those not in it are fetched one by one
+   */
+  void
+  onFetchedBatch(const ConstBufferPtr& content, const std::vector<Name>& requestedRecords);
+
+  // Interest format:
+  // /<peer_prefix>/BATCH/<depth>/<record full name>[/<version>/<segment>]
+  // Replies the ancestors of the record down to the depth, as segments of a block of records
+  void
+  onBatchRequest(const Interest& interest);
+
+  std::vector<shared_ptr<Data>>
+  makeBatch(const Name& requestName, const Name& recordName, size_t depth);
+
   /**
    * Adds the record to backend and the tailing record map
    * @param record
@@ -88,47 +245,144 @@ private:
   //Siqi's temp function
   struct TailingRecordState{
       bool parentEndorseVerified;
-      std::set<Name> refSet;
       bool recordEndorseVerified;
       Record record;
       time::system_clock::TimePoint addedTime;
   };
-  static void dumpList(const std::map<Name, TailingRecordState>& weight);
+  void dumpList() const;
+
+  /**
+   * @return the tailing state of the record, or nullptr if the record is not tailing
+   */
+  TailingRecordState* findTailingRecord(const Name& recordName);
+  const TailingRecordState* findTailingRecord(const Name& recordName) const;
 
   /**
-   * Check if the ancestor of the record is OK
-   * @param record the record to be checked
+   * @return the number of distinct producers that endorsed the tailing record
+   */
+  size_t getWeight(NameHandle record) const;
+
+  /**
+   * @return the handle of the producer prefix; producer handles are never released
+   */
+  NameHandle getProducerHandle(const Name& producerPrefix);
+
+  /**
+   * removes the record from the tailing record map and the weight engine
+   */
+  void removeTailingRecord(NameHandle record);
+
+  /**
+   * Check if the ancestor of a record in the sync stack is OK.
+   * If not, the record waits on its missing ancestors until they become available.
+   * @param record the handle of the record to be checked
    * @return true if the record is resolved; it is added or set as bad Record
    */
-  bool checkRecordAncestor(const Record &record);
+  bool checkRecordAncestor(NameHandle record);
+
+  /**
+   * wakes up the records in the sync stack that wait on the records made available
+   * by addToTailingRecord (newly added or newly parentEndorseVerified)
+   */
+  void processAvailableRecords();
+
+  /**
+   * removes the record from the ancestor index of the sync stack
+   */
+  void stopWaitingOnAncestors(NameHandle record);
+
+  /**
+   * handles removal of records in the sync stack that failed to get their ancestors in time
+   */
+  void removeTimeoutPendingRecords();
 
   /**
    * handles the information when a record is accepted.
    */
   void onRecordConfirmed(const Record &record);
 
+  /**
+   * commits the pending backend writes, and retries later if the write fails
+   */
+  void flushBackend();
+
   /**
    * handles removal of timeout records
    */
   void removeTimeoutRecords();
 
+  /**
+   * schedules removeTimeoutRecords() at the expiry time of the oldest tailing record
+   */
+  void scheduleTimeoutRemoval();
+
 private:
   Config m_config;
   Face& m_network;
   Scheduler m_scheduler;
   Backend m_backend;
+  mutable LruCache<Record> m_recordCache; // decoded records read from the backend
   security::KeyChain& m_keychain;
+  RecordFetcher m_fetcher;
 
-  std::map<Name, TailingRecordState> m_tailRecords;
+  // record full names referenced by the tailing records, the sync stack and the last cert records
+  NameTable m_recordNames;
+  NameTable m_producerNames;
+  std::unordered_map<NameHandle, TailingRecordState> m_tailRecords;
+  WeightEngine m_weightEngine;
+  // tailing records ordered by the time they were added; entries of removed records are skipped lazily
+  using ExpiryEntry = std::pair<time::system_clock::TimePoint, NameHandle>;
+  std::priority_queue<ExpiryEntry, std::vector<ExpiryEntry>, std::greater<ExpiryEntry>> m_expiryQueue;
+  scheduler::EventId m_expiryEventID;
+  scheduler::EventId m_flushEventID;
 
   // Zhiyi's temp member variable
-  std::list<std::pair<Record, time::system_clock::TimePoint>> m_syncStack;
+  struct PendingRecord {
+      RecordView record;
+      time::system_clock::TimePoint addedTime;
+      std::vector<NameHandle> waitingOn; // missing ancestors the record is registered under
+  };
+  std::unordered_map<NameHandle, PendingRecord> m_syncStack;
+  // missing ancestor -> records in the sync stack waiting on it
+  std::unordered_map<NameHandle, std::vector<NameHandle>> m_pendingByAncestor;
+  std::priority_queue<ExpiryEntry, std::vector<ExpiryEntry>, std::greater<ExpiryEntry>> m_syncStackDeadlines;
+  std::vector<NameHandle> m_availableRecords;
+  bool m_isProcessingAvailableRecords = false;
+
+  // batch fetching of ancestors
+  const static size_t BATCH_SEGMENT_SIZE = 7000;
+  const static size_t MAX_BATCH_SEGMENTS = 64;
+  const static size_t MAX_KEPT_BATCHES = 8;
+  security::ValidatorNull m_batchValidator; // records in a batch are verified one by one
+  size_t m_pendingBatchCount = 0;
+  std::deque<std::pair<Name, std::vector<shared_ptr<Data>>>> m_batchResponses;
 
   // Siqi's temp member variable
+  const static uint32_t T_TailingDigests = 131;
+  const static uint32_t T_SyncStateName = 132;
+  const static size_t MAX_KEPT_SYNC_STATES = 4;
+  // truncated digest -> tailing record
+  std::unordered_map<uint64_t, NameHandle> m_tailingDigests;
+  // recently announced sync states, served to peers that miss some of the digests
+  std::deque<std::pair<Name, std::vector<Name>>> m_syncStates;
+  // summaries of the accepted records for set reconciliation
+  const static uint32_t T_BucketSummary = 133;
+  const static uint32_t T_BucketIndex = 134;
+  const static uint32_t T_BucketCount = 135;
+  const static uint32_t T_BucketDigest = 136;
+  const static uint32_t T_BucketCursor = 137;
+  // record names per bucket listing Data, small enough for long names to fit in a packet
+  const static size_t BUCKET_PAGE_SIZE = 32;
+  // record names read at once when summarizing buckets from the storage
+  const static size_t BUCKET_SCAN_PAGE_SIZE = 1024;
+  SyncBuckets m_syncBuckets;
+  time::steady_clock::TimePoint m_nextReconcileTime;
   scheduler::EventId m_syncEventID;
   scheduler::EventId m_replySyncEventID;
   std::mt19937_64 m_randomEngine{std::random_device{}()};
-  std::list<Name> m_lastCertRecords; // for certificate chains
+  std::list<NameHandle> m_lastCertRecords; // for certificate chains
+  // last, so that the verification threads stop before the state they read is destroyed
+  VerificationPool m_verificationPool;
 };
 
 } // namespace DLedger
@@ -0,0 +1,118 @@
+#include "leveldb-engine.hpp"
+
+#include <leveldb/write_batch.h>
+#include <ndn-cxx/name.hpp>
+
+#include <cassert>
+#include <iostream>
+
+namespace dledger {
+
+// the format record sorts before every record key, which starts with a component type
+const std::string LevelDbEngine::FORMAT_KEY("\0format", 7);
+const std::string LevelDbEngine::FORMAT_BINARY_KEYS("binary-keys");
+
+LevelDbEngine::LevelDbEngine(const std::string& dbDir)
+{
+    leveldb::Options options;
+    options.create_if_missing = true;
+    leveldb::Status status = leveldb::DB::Open(options, dbDir, &m_db);
+    if (!status.ok()) {
+        std::cerr << "Unable to open/create database " << dbDir << std::endl;
+        std::cerr << status.ToString() << std::endl;
+        BOOST_THROW_EXCEPTION(std::runtime_error("Unable to open/create database"));
+    }
+    std::string format;
+    status = m_db->Get(leveldb::ReadOptions(), FORMAT_KEY, &format);
+    if (!status.ok() || format != FORMAT_BINARY_KEYS) {
+        migrateUriKeys();
+    }
+}
+
+LevelDbEngine::~LevelDbEngine()
+{
+  delete m_db;
+}
+
+void
+LevelDbEngine::migrateUriKeys()
+{
+  // databases written before the binary keys are keyed by the name URI, which starts with '/'
+  size_t count = 0;
+  leveldb::WriteBatch batch;
+  leveldb::Iterator* it = m_db->NewIterator(leveldb::ReadOptions());
+  for (it->Seek("/"); it->Valid() && it->key().starts_with("/"); it->Next()) {
+    // same as Backend::makeKey
+    const auto& wire = Name(it->key().ToString()).wireEncode();
+    batch.Put(leveldb::Slice(reinterpret_cast<const char*>(wire.value()), wire.value_size()), it->value());
+    batch.Delete(it->key());
+    count++;
+  }
+  assert(it->status().ok());  // Check for any errors found during the scan
+  delete it;
+  batch.Put(FORMAT_KEY, FORMAT_BINARY_KEYS);
+  leveldb::Status s = m_db->Write(leveldb::WriteOptions(), &batch);
+  if (!s.ok()) {
+    std::cerr << "Unable to migrate database keys" << std::endl;
+    std::cerr << s.ToString() << std::endl;
+    BOOST_THROW_EXCEPTION(std::runtime_error("Unable to migrate database keys"));
+  }
+  if (count != 0) {
+    std::cerr << "Migrated " << count << " records to binary keys" << std::endl;
+  }
+}
+
+ConstBufferPtr
+LevelDbEngine::get(const std::string& key) const
+{
+  // a point lookup through Get, which checks the table filters and skips the iterator setup;
+  // Get only returns the value as a string, which is copied again into the buffer for the Block
+  std::string value;
+  leveldb::Status s = m_db->Get(leveldb::ReadOptions(), key, &value);
+  if (!s.ok()) {
+    if (!s.IsNotFound()) {
+      std::cerr << "Unable to read value from database" << std::endl;
+      std::cerr << s.ToString() << std::endl;
+    }
+    return nullptr;
+  }
+  return make_shared<Buffer>(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+}
+
+bool
+LevelDbEngine::write(const std::vector<Write>& writes)
+{
+  leveldb::WriteBatch batch;
+  for (const auto& item : writes) {
+    if (item.value == nullptr) {
+      batch.Delete(item.key);
+    }
+    else {
+      batch.Put(item.key, leveldb::Slice(reinterpret_cast<const char*>(item.value), item.valueSize));
+    }
+  }
+  leveldb::Status s = m_db->Write(leveldb::WriteOptions(), &batch);
+  if (!s.ok()) {
+    std::cerr << "Unable to write batch to database" << std::endl;
+    std::cerr << s.ToString() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+std::vector<std::string>
+LevelDbEngine::listKeys(const std::string& begin, const std::string& end, size_t limit) const
+{
+  std::vector<std::string> keys;
+  leveldb::Iterator* it = m_db->NewIterator(leveldb::ReadOptions());
+  for (it->Seek(begin); it->Valid() && keys.size() < limit && (end.empty() || it->key().compare(end) < 0);
+       it->Next()) {
+    if (it->key() == FORMAT_KEY) continue;
+    keys.push_back(it->key().ToString());
+  }
+  assert(it->status().ok());  // Check for any errors found during the scan
+  delete it;
+  return keys;
+}
+
+}  // namespace dledger
@@ -0,0 +1,46 @@
+#ifndef DLEDGER_SRC_LEVELDB_ENGINE_H_
+#define DLEDGER_SRC_LEVELDB_ENGINE_H_
+
+#include "storage-engine.hpp"
+
+#include <leveldb/db.h>
+
+namespace dledger {
+
+/**
+ * The storage engine on top of LevelDB.
+ */
+class LevelDbEngine : public StorageEngine
+{
+public:
+  explicit
+  LevelDbEngine(const std::string& dbDir);
+
+  ~LevelDbEngine() override;
+
+  ConstBufferPtr
+  get(const std::string& key) const override;
+
+  bool
+  write(const std::vector<Write>& writes) override;
+
+  std::vector<std::string>
+  listKeys(const std::string& begin, const std::string& end,
+           size_t limit = std::numeric_limits<size_t>::max()) const override;
+
+private:
+  /**
+   * re-key the records of a database written with URI keys
+   */
+  void
+  migrateUriKeys();
+
+private:
+  static const std::string FORMAT_KEY;
+  static const std::string FORMAT_BINARY_KEYS;
+  leveldb::DB* m_db;
+};
+
+}  // namespace dledger
+
+#endif  // DLEDGER_SRC_LEVELDB_ENGINE_H_
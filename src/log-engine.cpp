@@ -0,0 +1,220 @@
+#include "log-engine.hpp"
+
+#include <boost/crc.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dledger {
+
+static uint32_t
+computeChecksum(uint32_t keySize, uint32_t valueSize, const uint8_t* body, size_t bodySize)
+{
+  boost::crc_32_type crc;
+  crc.process_bytes(&keySize, sizeof(keySize));
+  crc.process_bytes(&valueSize, sizeof(valueSize));
+  crc.process_bytes(body, bodySize);
+  return crc.checksum();
+}
+
+LogEngine::LogEngine(const std::string& dbDir, size_t segmentSize)
+    : m_dir(dbDir)
+    , m_segmentSize(segmentSize)
+{
+  if (::mkdir(m_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+    std::cerr << "Unable to create log directory " << m_dir << ": " << std::strerror(errno) << std::endl;
+    BOOST_THROW_EXCEPTION(std::runtime_error("Unable to open/create database"));
+  }
+  for (uint32_t segment = 0; ::access(getSegmentPath(segment).c_str(), F_OK) == 0; segment++) {
+    openSegment(segment);
+  }
+  if (m_fds.empty()) {
+    openSegment(0);
+  }
+
+  for (uint32_t segment = 0; segment < m_fds.size(); segment++) {
+    bool isTail = segment + 1 == m_fds.size();
+    uint64_t validSize = scanSegment(segment, isTail);
+    if (!isTail) continue;
+    struct stat st;
+    if (::fstat(m_fds.back(), &st) == 0 && static_cast<uint64_t>(st.st_size) > validSize) {
+      std::cerr << "Cut off " << st.st_size - validSize << " bytes of torn entries in " << getSegmentPath(segment) << std::endl;
+      if (::ftruncate(m_fds.back(), validSize) != 0) {
+        BOOST_THROW_EXCEPTION(std::runtime_error("Unable to recover database"));
+      }
+    }
+    m_tailSize = validSize;
+  }
+}
+
+LogEngine::~LogEngine()
+{
+  for (int fd : m_fds) {
+    ::close(fd);
+  }
+}
+
+std::string
+LogEngine::getSegmentPath(uint32_t segment) const
+{
+  return m_dir + "/" + std::to_string(segment) + ".log";
+}
+
+void
+LogEngine::openSegment(uint32_t segment)
+{
+  int fd = ::open(getSegmentPath(segment).c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    std::cerr << "Unable to open segment " << getSegmentPath(segment) << ": " << std::strerror(errno) << std::endl;
+    BOOST_THROW_EXCEPTION(std::runtime_error("Unable to open/create database"));
+  }
+  m_fds.push_back(fd);
+}
+
+uint64_t
+LogEngine::scanSegment(uint32_t segment, bool isTail)
+{
+  int fd = m_fds[segment];
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    BOOST_THROW_EXCEPTION(std::runtime_error("Unable to read database"));
+  }
+  uint64_t fileSize = st.st_size;
+  uint64_t offset = 0;
+  uint64_t committedSize = 0;
+  // the entries of the current batch are indexed only once its commit entry is read;
+  // a delete is kept with the size DELETED
+  std::vector<std::pair<std::string, Location>> batch;
+  std::vector<uint8_t> body;
+  while (offset + HEADER_SIZE <= fileSize) {
+    uint32_t header[3];
+    if (::pread(fd, header, HEADER_SIZE, offset) != static_cast<ssize_t>(HEADER_SIZE)) break;
+    uint32_t keySize = header[1];
+    uint32_t valueSize = header[2];
+    if (keySize == COMMIT) {
+      if (valueSize != batch.size()) break;
+      if (isTail && computeChecksum(keySize, valueSize, nullptr, 0) != header[0]) break;
+      for (auto& entry : batch) {
+        if (entry.second.size == DELETED) {
+          m_index.erase(entry.first);
+        }
+        else {
+          m_index[entry.first] = entry.second;
+        }
+      }
+      batch.clear();
+      offset += HEADER_SIZE;
+      committedSize = offset;
+      continue;
+    }
+
+    uint64_t valueBytes = valueSize == DELETED ? 0 : valueSize;
+    if (offset + HEADER_SIZE + keySize + valueBytes > fileSize) break;
+
+    body.resize(isTail ? keySize + valueBytes : keySize);
+    if (::pread(fd, body.data(), body.size(), offset + HEADER_SIZE) != static_cast<ssize_t>(body.size())) break;
+    if (isTail && computeChecksum(keySize, valueSize, body.data(), body.size()) != header[0]) break;
+
+    std::string key(body.begin(), body.begin() + keySize);
+    batch.emplace_back(std::move(key), Location{segment, offset + HEADER_SIZE + keySize, valueSize});
+    offset += HEADER_SIZE + keySize + valueBytes;
+  }
+  return committedSize;
+}
+
+ConstBufferPtr
+LogEngine::get(const std::string& key) const
+{
+  auto it = m_index.find(key);
+  if (it == m_index.end()) {
+    return nullptr;
+  }
+  const auto& location = it->second;
+  auto buffer = make_shared<Buffer>(location.size);
+  if (::pread(m_fds[location.segment], buffer->data(), location.size, location.offset) !=
+      static_cast<ssize_t>(location.size)) {
+    std::cerr << "Unable to read value from database: " << std::strerror(errno) << std::endl;
+    return nullptr;
+  }
+  return buffer;
+}
+
+bool
+LogEngine::write(const std::vector<Write>& writes)
+{
+  if (writes.empty()) {
+    return true;
+  }
+  // the whole batch goes to the tail with one write, closed by the commit entry
+  std::vector<uint8_t> entries;
+  std::vector<uint64_t> valueOffsets;
+  for (const auto& item : writes) {
+    uint32_t keySize = item.key.size();
+    uint32_t valueSize = item.value == nullptr ? DELETED : item.valueSize;
+    size_t bodyStart = entries.size() + HEADER_SIZE;
+    entries.resize(bodyStart);
+    entries.insert(entries.end(), item.key.begin(), item.key.end());
+    if (item.value != nullptr) {
+      entries.insert(entries.end(), item.value, item.value + item.valueSize);
+    }
+    uint32_t header[3] = {computeChecksum(keySize, valueSize, entries.data() + bodyStart, entries.size() - bodyStart),
+                          keySize, valueSize};
+    std::memcpy(entries.data() + bodyStart - HEADER_SIZE, header, HEADER_SIZE);
+    valueOffsets.push_back(bodyStart + keySize);
+  }
+  uint32_t entryCount = writes.size();
+  uint32_t commit[3] = {computeChecksum(COMMIT, entryCount, nullptr, 0), COMMIT, entryCount};
+  entries.insert(entries.end(), reinterpret_cast<const uint8_t*>(commit),
+                 reinterpret_cast<const uint8_t*>(commit) + HEADER_SIZE);
+
+  if (m_tailSize > 0 && m_tailSize + entries.size() > m_segmentSize) {
+    openSegment(m_fds.size());
+    m_tailSize = 0;
+  }
+  int fd = m_fds.back();
+  size_t written = 0;
+  while (written < entries.size()) {
+    ssize_t n = ::pwrite(fd, entries.data() + written, entries.size() - written, m_tailSize + written);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) {
+      std::cerr << "Unable to append to database: " << std::strerror(errno) << std::endl;
+      if (::ftruncate(fd, m_tailSize) != 0) {
+        std::cerr << "Unable to cut off the failed append" << std::endl;
+      }
+      return false;
+    }
+    written += n;
+  }
+
+  uint32_t segment = m_fds.size() - 1;
+  for (size_t i = 0; i < writes.size(); i++) {
+    if (writes[i].value == nullptr) {
+      m_index.erase(writes[i].key);
+    }
+    else {
+      m_index[writes[i].key] = Location{segment, m_tailSize + valueOffsets[i], static_cast<uint32_t>(writes[i].valueSize)};
+    }
+  }
+  m_tailSize += entries.size();
+  return true;
+}
+
+std::vector<std::string>
+LogEngine::listKeys(const std::string& begin, const std::string& end, size_t limit) const
+{
+  std::vector<std::string> keys;
+  for (auto it = m_index.lower_bound(begin);
+       it != m_index.end() && keys.size() < limit && (end.empty() || it->first < end); ++it) {
+    keys.push_back(it->first);
+  }
+  return keys;
+}
+
+}  // namespace dledger
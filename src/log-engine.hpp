@@ -0,0 +1,84 @@
+#ifndef DLEDGER_SRC_LOG_ENGINE_H_
+#define DLEDGER_SRC_LOG_ENGINE_H_
+
+#include "storage-engine.hpp"
+
+#include <map>
+
+namespace dledger {
+
+/**
+ * An append-only storage engine for write-once records.
+ * Writes are appended to the tail segment file of a directory, and a new segment is started once
+ * the tail grows past the segment size. Each entry carries a CRC-32 and each write batch ends with
+ * a commit entry, so a torn batch at the tail is detected and cut off as a whole when the log is
+ * reopened. The index from key to value location is kept in memory, sorted by key, and rebuilt by
+ * scanning the segments when the log is opened.
+ *
+ * Entry format, in host byte order: CRC-32 | key size | value size (UINT32_MAX for a delete) | key | value
+ * Commit entry: CRC-32 | UINT32_MAX | number of entries in the batch
+ */
+class LogEngine : public StorageEngine
+{
+public:
+  /**
+   * @param dbDir the directory of the segments, created if it does not exist
+   * @param segmentSize the size after which writes go to a new segment
+   */
+  explicit
+  LogEngine(const std::string& dbDir, size_t segmentSize = 64 * 1024 * 1024);
+
+  ~LogEngine() override;
+
+  ConstBufferPtr
+  get(const std::string& key) const override;
+
+  bool
+  write(const std::vector<Write>& writes) override;
+
+  std::vector<std::string>
+  listKeys(const std::string& begin, const std::string& end,
+           size_t limit = std::numeric_limits<size_t>::max()) const override;
+
+  size_t
+  getSegmentCount() const
+  {
+    return m_fds.size();
+  }
+
+private:
+  std::string
+  getSegmentPath(uint32_t segment) const;
+
+  void
+  openSegment(uint32_t segment);
+
+  /**
+   * index the committed batches of a segment; the checksums are only verified for the tail segment,
+   * the only one that a crash can leave torn
+   * @return the size of the committed batches
+   */
+  uint64_t
+  scanSegment(uint32_t segment, bool isTail);
+
+private:
+  struct Location {
+    uint32_t segment;
+    uint64_t offset;
+    uint32_t size;
+  };
+
+  static const uint32_t DELETED = UINT32_MAX;
+  static const uint32_t COMMIT = UINT32_MAX; // key size of the commit entry
+  static const size_t HEADER_SIZE = 3 * sizeof(uint32_t);
+
+  std::string m_dir;
+  size_t m_segmentSize;
+  std::vector<int> m_fds;
+  uint64_t m_tailSize = 0;
+  std::map<std::string, Location> m_index;
+};
+
+}  // namespace dledger
+
+#endif  // DLEDGER_SRC_LOG_ENGINE_H_
@@ -0,0 +1,126 @@
+#ifndef DLEDGER_SRC_LRU_CACHE_H_
+#define DLEDGER_SRC_LRU_CACHE_H_
+
+#include <ndn-cxx/name.hpp>
+
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+
+using namespace ndn;
+namespace dledger {
+
+/**
+ * A size-bounded cache keyed by name that evicts the least recently used entry.
+ * Lookups are counted so that the hit rate can be reported.
+ * The cache is not synchronized: the record cache is only used on the Face thread, and the
+ * verification cache of the certificate manager is guarded by the manager's own mutex.
+ */
+template<class Value>
+class LruCache
+{
+public:
+  /**
+   * @param capacity the maximum number of entries, at least one
+   */
+  explicit
+  LruCache(size_t capacity)
+    : m_capacity(std::max<size_t>(capacity, 1))
+  {
+  }
+
+  /**
+   * @return the cached value, or nullptr on a miss; a hit makes the entry the most recently used
+   */
+  const Value*
+  find(const Name& name)
+  {
+    auto it = m_index.find(name);
+    if (it == m_index.end()) {
+      m_missCount++;
+      return nullptr;
+    }
+    m_hitCount++;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return &it->second->second;
+  }
+
+  /**
+   * @return the cached copy of the value
+   */
+  const Value&
+  insert(const Name& name, const Value& value)
+  {
+    auto it = m_index.find(name);
+    if (it != m_index.end()) {
+      it->second->second = value;
+      m_entries.splice(m_entries.begin(), m_entries, it->second);
+      return it->second->second;
+    }
+    if (m_entries.size() >= m_capacity) {
+      m_index.erase(m_entries.back().first);
+      m_entries.pop_back();
+    }
+    m_entries.emplace_front(name, value);
+    m_index.emplace(name, m_entries.begin());
+    return m_entries.front().second;
+  }
+
+  void
+  erase(const Name& name)
+  {
+    auto it = m_index.find(name);
+    if (it != m_index.end()) {
+      m_entries.erase(it->second);
+      m_index.erase(it);
+    }
+  }
+
+  /**
+   * erases the entries whose names are under the prefix, by a scan over all the entries
+   */
+  void
+  erasePrefix(const Name& prefix)
+  {
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+      if (prefix.isPrefixOf(it->first)) {
+        m_index.erase(it->first);
+        it = m_entries.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+  }
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+  uint64_t
+  getHitCount() const
+  {
+    return m_hitCount;
+  }
+
+  uint64_t
+  getMissCount() const
+  {
+    return m_missCount;
+  }
+
+private:
+  using Entry = std::pair<Name, Value>;
+
+  size_t m_capacity;
+  std::list<Entry> m_entries; // most recently used first
+  std::unordered_map<Name, typename std::list<Entry>::iterator> m_index;
+  uint64_t m_hitCount = 0;
+  uint64_t m_missCount = 0;
+};
+
+}  // namespace dledger
+
+#endif  // DLEDGER_SRC_LRU_CACHE_H_
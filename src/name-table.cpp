@@ -0,0 +1,51 @@
+#include "name-table.hpp"
+
+namespace dledger {
+
+const NameHandle NameTable::INVALID_HANDLE = UINT32_MAX;
+
+NameHandle
+NameTable::acquire(const Name& name)
+{
+  auto it = m_handles.find(std::cref(name));
+  if (it != m_handles.end()) {
+    m_entries[it->second].refCount++;
+    return it->second;
+  }
+
+  NameHandle handle;
+  if (!m_freeHandles.empty()) {
+    handle = m_freeHandles.back();
+    m_freeHandles.pop_back();
+  }
+  else {
+    handle = static_cast<NameHandle>(m_entries.size());
+    m_entries.emplace_back();
+  }
+  auto& entry = m_entries[handle];
+  entry.name = name;
+  entry.refCount = 1;
+  m_handles.emplace(std::cref(entry.name), handle);
+  return handle;
+}
+
+void
+NameTable::release(NameHandle handle)
+{
+  auto& entry = m_entries[handle];
+  if (entry.refCount == 0 || --entry.refCount > 0) {
+    return;
+  }
+  m_handles.erase(std::cref(entry.name));
+  entry.name = Name();
+  m_freeHandles.push_back(handle);
+}
+
+NameHandle
+NameTable::find(const Name& name) const
+{
+  auto it = m_handles.find(std::cref(name));
+  return it == m_handles.end() ? INVALID_HANDLE : it->second;
+}
+
+}  // namespace dledger
@@ -0,0 +1,82 @@
+#ifndef DLEDGER_SRC_NAME_TABLE_H_
+#define DLEDGER_SRC_NAME_TABLE_H_
+
+#include <ndn-cxx/name.hpp>
+
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+using namespace ndn;
+namespace dledger {
+
+/**
+ * A compact handle of an interned name.
+ */
+using NameHandle = uint32_t;
+
+/**
+ * Interns names into dense 32-bit handles.
+ * A name is hashed once when it is acquired; afterwards the handle can be used as a key
+ * in place of the name. Handles are reference counted and recycled after the last release.
+ */
+class NameTable
+{
+public:
+  static const NameHandle INVALID_HANDLE;
+
+  /**
+   * Get the handle of the name, interning the name if it is not in the table yet.
+   * Each call must be paired with a release().
+   */
+  NameHandle
+  acquire(const Name& name);
+
+  /**
+   * Drop one reference to the handle. The handle is recycled when no reference is left.
+   */
+  void
+  release(NameHandle handle);
+
+  /**
+   * @return the handle of the name, or INVALID_HANDLE if the name is not interned
+   */
+  NameHandle
+  find(const Name& name) const;
+
+  const Name&
+  getName(NameHandle handle) const
+  {
+    return m_entries[handle].name;
+  }
+
+  size_t
+  size() const
+  {
+    return m_handles.size();
+  }
+
+private:
+  struct Entry {
+    Name name;
+    uint32_t refCount = 0;
+  };
+
+  struct NameRefHash {
+    size_t
+    operator()(const Name& name) const
+    {
+      return std::hash<Name>()(name);
+    }
+  };
+
+  // entries are kept in a deque so that the names referenced by m_handles never move
+  std::deque<Entry> m_entries;
+  std::vector<NameHandle> m_freeHandles;
+  std::unordered_map<std::reference_wrapper<const Name>, NameHandle, NameRefHash, std::equal_to<Name>> m_handles;
+};
+
+}  // namespace dledger
+
+#endif  // DLEDGER_SRC_NAME_TABLE_H_
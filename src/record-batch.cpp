@@ -0,0 +1,63 @@
+#include "record-batch.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+namespace dledger {
+
+Name
+RecordBatch::makeRequestName(const Name& producerPrefix, size_t depth, const Name& recordName)
+{
+  const auto& recordWire = recordName.wireEncode();
+  Name requestName = producerPrefix;
+  requestName.append("BATCH").appendNumber(depth).append(recordWire.wire(), recordWire.size());
+  return requestName;
+}
+
+Name
+RecordBatch::parseRequestName(const Name& interestName, size_t prefixSize, Name& recordName, size_t& depth)
+{
+  size_t requestSize = prefixSize + REQUEST_COMPONENT_COUNT;
+  if (interestName.size() < requestSize || interestName.get(prefixSize) != name::Component("BATCH")) {
+    BOOST_THROW_EXCEPTION(std::runtime_error("Not a batch request"));
+  }
+  depth = interestName.get(prefixSize + 1).toNumber();
+  recordName.wireDecode(interestName.get(prefixSize + 2).blockFromValue());
+  return interestName.getPrefix(requestSize);
+}
+
+std::vector<shared_ptr<Data>>
+RecordBatch::makeSegments(const Name& requestName, const std::vector<Block>& records, size_t segmentSize)
+{
+  auto batch = makeEmptyBlock(tlv::Content);
+  for (const auto& record : records) {
+    batch.push_back(record);
+  }
+  batch.encode();
+
+  std::vector<shared_ptr<Data>> segments;
+  Name versionedName = requestName;
+  versionedName.appendVersion();
+  size_t segmentCount = std::max<size_t>(1, (batch.size() + segmentSize - 1) / segmentSize);
+  for (size_t i = 0; i < segmentCount; i++) {
+    auto segment = make_shared<Data>(Name(versionedName).appendSegment(i));
+    size_t offset = i * segmentSize;
+    segment->setContent(batch.wire() + offset, std::min(batch.size() - offset, segmentSize));
+    segment->setFinalBlock(name::Component::fromSegment(segmentCount - 1));
+    segments.push_back(segment);
+  }
+  return segments;
+}
+
+std::vector<shared_ptr<const Data>>
+RecordBatch::parse(const ConstBufferPtr& content)
+{
+  std::vector<shared_ptr<const Data>> records;
+  Block batch(content);
+  batch.parse();
+  for (const auto& item : batch.elements()) {
+    records.push_back(make_shared<Data>(item));
+  }
+  return records;
+}
+
+}  // namespace dledger
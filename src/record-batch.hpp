@@ -0,0 +1,57 @@
+#ifndef DLEDGER_SRC_RECORD_BATCH_H_
+#define DLEDGER_SRC_RECORD_BATCH_H_
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/name.hpp>
+
+#include <vector>
+
+using namespace ndn;
+namespace dledger {
+
+/**
+ * The names and the content of the batches of records, with which a peer replies the ancestors
+ * of one of its records at once.
+ * Request name: /<producer_prefix>/BATCH/<depth>/<record full name>[/<version>/<segment>]
+ * where the record full name is carried as the value of a generic name component.
+ * The batch is a Content TLV of the record Data packets, split into segments.
+ */
+class RecordBatch
+{
+public:
+  /**
+   * @return the name to request the ancestors of the record down to the depth
+   */
+  static Name
+  makeRequestName(const Name& producerPrefix, size_t depth, const Name& recordName);
+
+  /**
+   * Parse a batch request name.
+   * @param prefixSize the size of the producer prefix
+   * @return the request name without version and segment
+   * @throw tlv::Error or std::runtime_error if the name is not a batch request
+   */
+  static Name
+  parseRequestName(const Name& interestName, size_t prefixSize, Name& recordName, size_t& depth);
+
+  /**
+   * Encode the records into a batch and split it into unsigned segments of the request name.
+   * @param records the wire encoded records
+   */
+  static std::vector<shared_ptr<Data>>
+  makeSegments(const Name& requestName, const std::vector<Block>& records, size_t segmentSize);
+
+  /**
+   * Decode the records of a batch reassembled from its segments.
+   * @throw tlv::Error if the batch is malformed
+   */
+  static std::vector<shared_ptr<const Data>>
+  parse(const ConstBufferPtr& content);
+
+public:
+  const static size_t REQUEST_COMPONENT_COUNT = 3;
+};
+
+}  // namespace dledger
+
+#endif  // DLEDGER_SRC_RECORD_BATCH_H_
@@ -0,0 +1,121 @@
+#include "record-fetcher.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+NDN_LOG_INIT(dledger.fetcher);
+
+namespace dledger {
+
+RecordFetcher::RecordFetcher(Face& network, Scheduler& scheduler, size_t windowSize, size_t retryLimit,
+                             time::milliseconds retryBackoff, const OnFetchedRecord& onFetchedRecord)
+    : m_network(network)
+    , m_scheduler(scheduler)
+    , m_windowSize(windowSize)
+    , m_retryLimit(retryLimit)
+    , m_retryBackoff(retryBackoff)
+    , m_onFetchedRecord(onFetchedRecord)
+{
+}
+
+RecordFetcher::~RecordFetcher()
+{
+  for (auto& item : m_requests) {
+    item.second.pendingInterest.cancel();
+    if (item.second.retryEvent) item.second.retryEvent.cancel();
+  }
+}
+
+void
+RecordFetcher::fetch(const Name& recordName)
+{
+  auto& request = m_requests[recordName];
+  request.demand++;
+  if (request.demand == 1) {
+    enqueue(recordName, request);
+  }
+  else if (request.isQueued) {
+    // re-insert with the raised demand
+    m_queue.erase(request.queuePosition);
+    enqueue(recordName, request);
+  }
+  else {
+    NDN_LOG_TRACE("[RecordFetcher::fetch] Merged request for " << recordName);
+  }
+  dispatch();
+}
+
+void
+RecordFetcher::enqueue(const Name& recordName, Request& request)
+{
+  request.queuePosition = m_queue.emplace(std::make_pair(request.demand, m_sequence++), recordName).first;
+  request.isQueued = true;
+}
+
+void
+RecordFetcher::dispatch()
+{
+  while (m_outstandingCount < m_windowSize && !m_queue.empty()) {
+    Name recordName = m_queue.begin()->second;
+    m_queue.erase(m_queue.begin());
+    auto& request = m_requests[recordName];
+    request.isQueued = false;
+
+    Interest interestForRecord(recordName);
+    interestForRecord.setCanBePrefix(false);
+    interestForRecord.setMustBeFresh(true);
+    NDN_LOG_INFO("[RecordFetcher::dispatch] Fetch the record: " << recordName.toUri()
+                 << " (requested " << request.demand << " times, retry " << request.retries << ")");
+    request.pendingInterest = m_network.expressInterest(interestForRecord,
+                                  bind(&RecordFetcher::onData, this, _1, _2),
+                                  [this] (const Interest& interest, const lp::Nack& nack) {
+                                    NDN_LOG_ERROR("Received Nack with reason " << nack.getReason());
+                                    onFailure(interest);
+                                  },
+                                  [this] (const Interest& interest) {
+                                    NDN_LOG_ERROR("Timeout for " << interest);
+                                    onFailure(interest);
+                                  });
+    m_outstandingCount++;
+  }
+}
+
+void
+RecordFetcher::onData(const Interest& interest, const Data& data)
+{
+  auto it = m_requests.find(interest.getName());
+  if (it != m_requests.end()) {
+    m_requests.erase(it);
+    m_outstandingCount--;
+  }
+  m_onFetchedRecord(interest, data);
+  dispatch();
+}
+
+void
+RecordFetcher::onFailure(const Interest& interest)
+{
+  auto it = m_requests.find(interest.getName());
+  if (it == m_requests.end()) return;
+  m_outstandingCount--;
+
+  auto& request = it->second;
+  if (request.retries >= m_retryLimit) {
+    NDN_LOG_WARN("[RecordFetcher::onFailure] Give up fetching " << interest.getName() << " after "
+                 << request.retries << " retries");
+    m_requests.erase(it);
+  }
+  else {
+    auto delay = m_retryBackoff * (1 << request.retries);
+    request.retries++;
+    Name recordName = interest.getName();
+    request.retryEvent = m_scheduler.schedule(delay, [this, recordName] {
+      auto retry = m_requests.find(recordName);
+      if (retry == m_requests.end()) return;
+      enqueue(recordName, retry->second);
+      dispatch();
+    });
+  }
+  dispatch();
+}
+
+}  // namespace dledger
@@ -0,0 +1,100 @@
+#ifndef DLEDGER_SRC_RECORD_FETCHER_H_
+#define DLEDGER_SRC_RECORD_FETCHER_H_
+
+#include <ndn-cxx/face.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <map>
+#include <unordered_map>
+
+using namespace ndn;
+namespace dledger {
+
+/**
+ * Fetches records by their full names.
+ * Requests for the same record are merged into one Interest, at most a window of Interests is
+ * outstanding at a time, and Interests that time out or are Nacked are retransmitted with
+ * exponential backoff. Among the queued records, the one requested the most times (i.e.,
+ * blocking the most records) is sent first.
+ */
+class RecordFetcher
+{
+public:
+  using OnFetchedRecord = function<void(const Interest&, const Data&)>;
+
+  RecordFetcher(Face& network, Scheduler& scheduler, size_t windowSize, size_t retryLimit,
+                time::milliseconds retryBackoff, const OnFetchedRecord& onFetchedRecord);
+
+  ~RecordFetcher();
+
+  /**
+   * Request a record. A request for a record that is already requested only raises its priority.
+   * @param recordName the full name of the record
+   */
+  void
+  fetch(const Name& recordName);
+
+  /**
+   * @return true if the record is queued, in flight, or waiting for a retransmission
+   */
+  bool
+  isFetching(const Name& recordName) const
+  {
+    return m_requests.count(recordName) != 0;
+  }
+
+  size_t
+  getOutstandingCount() const
+  {
+    return m_outstandingCount;
+  }
+
+private:
+  // queue order: most requested first, then first come first served
+  struct QueueOrder {
+    bool
+    operator()(const std::pair<size_t, uint64_t>& a, const std::pair<size_t, uint64_t>& b) const
+    {
+      return a.first != b.first ? a.first > b.first : a.second < b.second;
+    }
+  };
+  using Queue = std::map<std::pair<size_t, uint64_t>, Name, QueueOrder>;
+
+  struct Request {
+    size_t demand = 0;
+    size_t retries = 0;
+    bool isQueued = false;
+    Queue::iterator queuePosition;
+    PendingInterestHandle pendingInterest;
+    scheduler::EventId retryEvent;
+  };
+
+  void
+  enqueue(const Name& recordName, Request& request);
+
+  void
+  dispatch();
+
+  void
+  onData(const Interest& interest, const Data& data);
+
+  void
+  onFailure(const Interest& interest);
+
+private:
+  Face& m_network;
+  Scheduler& m_scheduler;
+  size_t m_windowSize;
+  size_t m_retryLimit;
+  time::milliseconds m_retryBackoff;
+  OnFetchedRecord m_onFetchedRecord;
+
+  std::unordered_map<Name, Request> m_requests;
+  Queue m_queue;
+  uint64_t m_sequence = 0;
+  size_t m_outstandingCount = 0;
+};
+
+}  // namespace dledger
+
+#endif  // DLEDGER_SRC_RECORD_FETCHER_H_
@@ -0,0 +1,18 @@
+#include "record-view.hpp"
+
+namespace dledger {
+
+RecordView::RecordView(shared_ptr<const Data> data)
+{
+  auto fields = make_shared<Fields>();
+  fields->record = Record(std::move(data));
+  if (fields->record.getType() == CERTIFICATE_RECORD) {
+    // the certificates are checked with the record format; only the previous certificate records are kept
+    CertificateRecord certRecord(fields->record);
+    const auto& prevCertificates = certRecord.getPrevCertificates();
+    fields->prevCertificates.assign(prevCertificates.begin(), prevCertificates.end());
+  }
+  m_fields = std::move(fields);
+}
+
+}  // namespace dledger
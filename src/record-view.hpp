@@ -0,0 +1,93 @@
+#ifndef DLEDGER_SRC_RECORD_VIEW_H_
+#define DLEDGER_SRC_RECORD_VIEW_H_
+
+#include "dledger/record.hpp"
+
+#include <ndn-cxx/data.hpp>
+
+#include <memory>
+
+using namespace ndn;
+namespace dledger {
+
+/**
+ * An immutable record decoded once from its Data, to be passed through validation and insertion.
+ * The view holds the decoded Record in shared fields, so copying a view never decodes or copies
+ * the record again; it does not avoid the one decoding of the record itself.
+ */
+class RecordView
+{
+public:
+  /**
+   * Parse the record.
+   * @throw std::runtime_error or tlv::Error if the Data is not a well-formed record
+   */
+  explicit
+  RecordView(shared_ptr<const Data> data);
+
+  const Record&
+  getRecord() const
+  {
+    return m_fields->record;
+  }
+
+  const Data&
+  getData() const
+  {
+    return *m_fields->record.getData();
+  }
+
+  /**
+   * @return the full name of the record
+   */
+  const Name&
+  getRecordName() const
+  {
+    return m_fields->record.getRecordName();
+  }
+
+  RecordType
+  getType() const
+  {
+    return m_fields->record.getType();
+  }
+
+  const Name&
+  getProducerPrefix() const
+  {
+    return m_fields->record.getProducerPrefix();
+  }
+
+  time::system_clock::TimePoint
+  getGenerationTimestamp() const
+  {
+    return m_fields->record.getGenerationTimestamp();
+  }
+
+  RecordSpan<Name>
+  getPointers() const
+  {
+    return m_fields->record.getPointersFromHeader();
+  }
+
+  /**
+   * @return the previous certificate records named by a certificate record; empty for other types
+   */
+  RecordSpan<Name>
+  getPrevCertificates() const
+  {
+    return m_fields->prevCertificates;
+  }
+
+private:
+  struct Fields {
+    Record record;
+    RecordElements<Name, 1> prevCertificates;
+  };
+
+  shared_ptr<const Fields> m_fields;
+};
+
+}  // namespace dledger
+
+#endif  // DLEDGER_SRC_RECORD_VIEW_H_
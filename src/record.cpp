@@ -7,18 +7,14 @@
 namespace dledger {
 
 Record::Record(RecordType type, const std::string& identifer)
-    : m_data(nullptr),
-      m_type(type),
+    : m_type(type),
       m_uniqueIdentifier(identifer)
 {
 }
 
-Record::Record(const std::shared_ptr<Data>& data)
-    : m_data(data)
+Record::Record(const std::shared_ptr<const Data>& data)
 {
-  RecordName name(m_data->getName());
-  m_type = name.getRecordType();
-  m_uniqueIdentifier = name.getRecordUniqueIdentifier();
+  setData(data);
   headerWireDecode(m_data->getContent());
   bodyWireDecode(m_data->getContent());
 }
@@ -28,15 +24,19 @@ Record::Record(ndn::Data data)
 {
 }
 
-Name
-Record::getRecordName() const
+void
+Record::setData(const std::shared_ptr<const Data>& data)
 {
-  if (m_data != nullptr)
-    return m_data->getFullName();
-  return Name();
+  RecordName name(data->getName());
+  m_data = data;
+  m_type = name.getRecordType();
+  m_uniqueIdentifier = name.getRecordUniqueIdentifier();
+  m_recordName = m_data->getFullName();
+  m_producerPrefix = name.getProducerPrefix();
+  m_generationTimestamp = name.getGenerationTimestamp();
 }
 
-const std::list<Name>&
+RecordSpan<Name>
 Record::getPointersFromHeader() const
 {
   return m_recordPointers;
@@ -51,7 +51,7 @@ Record::addRecordItem(const Block& recordItem)
   m_contentItems.push_back(recordItem);
 }
 
-const std::list<Block>&
+RecordSpan<Block>
 Record::getRecordItems() const
 {
   return m_contentItems;
@@ -72,36 +72,60 @@ Record::addPointer(const Name& pointer)
   m_recordPointers.push_back(pointer);
 }
 
-void
-Record::wireEncode(Block& block) const
+template<encoding::Tag TAG>
+size_t
+Record::wireEncode(EncodingImpl<TAG>& encoder) const
 {
-  headerWireEncode(block);
-  bodyWireEncode(block);
-}
+  // TLVs are prepended, so the body goes first and the elements are walked backwards
+  size_t bodyLength = 0;
+  for (auto item = m_contentItems.rbegin(); item != m_contentItems.rend(); ++item) {
+    bodyLength += prependBlock(encoder, *item);
+  }
+  size_t totalLength = bodyLength;
+  totalLength += encoder.prependVarNumber(bodyLength);
+  totalLength += encoder.prependVarNumber(T_RecordContent);
 
-Name
-Record::getProducerPrefix() const
-{
-  return RecordName(m_data->getName()).getProducerPrefix();
+  size_t headerLength = 0;
+  for (auto pointer = m_recordPointers.rbegin(); pointer != m_recordPointers.rend(); ++pointer) {
+    headerLength += pointer->wireEncode(encoder);
+  }
+  totalLength += headerLength;
+  totalLength += encoder.prependVarNumber(headerLength);
+  totalLength += encoder.prependVarNumber(T_RecordHeader);
+  return totalLength;
 }
 
-time::system_clock::TimePoint
-Record::getGenerationTimestamp() const
+template size_t
+Record::wireEncode<encoding::EncoderTag>(EncodingImpl<encoding::EncoderTag>& encoder) const;
+
+template size_t
+Record::wireEncode<encoding::EstimatorTag>(EncodingImpl<encoding::EstimatorTag>& encoder) const;
+
+Block
+Record::wireEncode() const
 {
-  return RecordName(m_data->getName()).getGenerationTimestamp();
+  EncodingEstimator estimator;
+  size_t estimatedLength = wireEncode(estimator);
+  estimatedLength += estimator.prependVarNumber(estimatedLength);
+  estimatedLength += estimator.prependVarNumber(tlv::Content);
+
+  EncodingBuffer buffer(estimatedLength, 0);
+  size_t length = wireEncode(buffer);
+  buffer.prependVarNumber(length);
+  buffer.prependVarNumber(tlv::Content);
+  return buffer.block();
 }
 
 void
-Record::headerWireEncode(Block& block) const
+Record::wireEncode(Block& block) const
 {
-  auto header = makeEmptyBlock(T_RecordHeader);
-  for (const auto& pointer : m_recordPointers) {
-    header.push_back(pointer.wireEncode());
+  auto content = wireEncode();
+  content.parse();
+  for (const auto& element : content.elements()) {
+    block.push_back(element);
   }
-  header.parse();
-  block.push_back(header);
   block.parse();
-};
+}
 
 void
 Record::headerWireDecode(const Block& dataContent) {
@@ -109,6 +133,7 @@ Record::headerWireDecode(const Block& dataContent) {
     dataContent.parse();
     const auto &headerBlock = dataContent.get(T_RecordHeader);
     headerBlock.parse();
+    m_recordPointers.reserve(headerBlock.elements_size());
     Name pointer;
     for (const auto &item : headerBlock.elements()) {
         if (item.type() == tlv::Name) {
@@ -125,24 +150,13 @@ Record::headerWireDecode(const Block& dataContent) {
     }
 }
 
-void
-Record::bodyWireEncode(Block& block) const
-{
-  auto body = makeEmptyBlock(T_RecordContent);
-  for (const auto& item : m_contentItems) {
-    body.push_back(item);
-  }
-  body.parse();
-  block.push_back(body);
-  block.parse();
-};
-
 void
 Record::bodyWireDecode(const Block& dataContent) {
     m_contentItems.clear();
     dataContent.parse();
     const auto &contentBlock = dataContent.get(T_RecordContent);
     contentBlock.parse();
+    m_contentItems.reserve(contentBlock.elements_size());
     for (const auto &item : contentBlock.elements()) {
         m_contentItems.push_back(item);
     }
@@ -200,7 +214,7 @@ CertificateRecord::addCertificateItem(const security::Certificate& certificate)
     addRecordItem(certificate.wireEncode());
 }
 
-const std::list<security::Certificate> &
+RecordSpan<security::Certificate>
 CertificateRecord::getCertificates() const
 {
     return m_cert_list;
@@ -212,7 +226,7 @@ CertificateRecord::addPrevCertPointer(const Name& recordName){
     addRecordItem(KeyLocator(recordName).wireEncode());
 }
 
-const std::list<Name> &
+RecordSpan<Name>
 CertificateRecord::getPrevCertificates() const{
     return m_prev_cert;
 }
@@ -237,7 +251,7 @@ RevocationRecord::addCertificateNameItem(const Name &certificateName){
     addRecordItem(certificateName.wireEncode());
 }
 
-const std::list<Name> &
+RecordSpan<Name>
 RevocationRecord::getRevokedCertificates() const{
     return m_revoked_cert_list;
 }
@@ -0,0 +1,23 @@
+#include "storage-engine.hpp"
+#include "leveldb-engine.hpp"
+#include "log-engine.hpp"
+
+#include <boost/throw_exception.hpp>
+
+#include <stdexcept>
+
+namespace dledger {
+
+std::unique_ptr<StorageEngine>
+StorageEngine::create(const std::string& type, const std::string& dbDir)
+{
+  if (type == "leveldb") {
+    return std::unique_ptr<StorageEngine>(new LevelDbEngine(dbDir));
+  }
+  if (type == "log") {
+    return std::unique_ptr<StorageEngine>(new LogEngine(dbDir));
+  }
+  BOOST_THROW_EXCEPTION(std::runtime_error("Unknown storage engine " + type));
+}
+
+}  // namespace dledger
@@ -0,0 +1,66 @@
+#ifndef DLEDGER_SRC_STORAGE_ENGINE_H_
+#define DLEDGER_SRC_STORAGE_ENGINE_H_
+
+#include <ndn-cxx/encoding/buffer.hpp>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace ndn;
+namespace dledger {
+
+/**
+ * The key-value store under the Backend.
+ * Keys are binary strings; the Backend keeps the records of a name prefix in a contiguous key range.
+ */
+class StorageEngine
+{
+public:
+  /**
+   * A put of the value, or a delete of the key if the value is nullptr.
+   * The value only needs to be valid during write().
+   */
+  struct Write {
+    std::string key;
+    const uint8_t* value;
+    size_t valueSize;
+  };
+
+  virtual
+  ~StorageEngine() = default;
+
+  /**
+   * @return the value of the key, or nullptr if the key is absent
+   * @note The value is copied out of the storage into the returned buffer: an ndn::Block can only
+   *       share an ndn::Buffer, which owns its bytes, so it cannot point into LevelDB's blocks or
+   *       into a mapped segment.
+   */
+  virtual ConstBufferPtr
+  get(const std::string& key) const = 0;
+
+  /**
+   * Apply the writes in order.
+   * @return false if the writes could not be stored
+   */
+  virtual bool
+  write(const std::vector<Write>& writes) = 0;
+
+  /**
+   * @return the first keys in [begin, end), at most @p limit, in byte order; an empty end means no upper bound
+   */
+  virtual std::vector<std::string>
+  listKeys(const std::string& begin, const std::string& end,
+           size_t limit = std::numeric_limits<size_t>::max()) const = 0;
+
+  /**
+   * Open the engine of the type, "leveldb" or "log", in the directory.
+   */
+  static std::unique_ptr<StorageEngine>
+  create(const std::string& type, const std::string& dbDir);
+};
+
+}  // namespace dledger
+
+#endif  // DLEDGER_SRC_STORAGE_ENGINE_H_
@@ -0,0 +1,66 @@
+#include "sync-buckets.hpp"
+
+#include <algorithm>
+
+namespace dledger {
+
+SyncBuckets::SyncBuckets(size_t windowSize)
+    : m_windowSize(std::max<size_t>(windowSize, 1))
+{
+}
+
+void
+SyncBuckets::advance(uint64_t latestBucket)
+{
+  if (latestBucket <= m_latestBucket) return;
+  m_latestBucket = latestBucket;
+  m_buckets.erase(m_buckets.begin(), m_buckets.lower_bound(getFirstBucket()));
+}
+
+bool
+SyncBuckets::insert(uint64_t bucket, uint64_t digest)
+{
+  if (!isTracked(bucket)) {
+    return false;
+  }
+  auto& entry = m_buckets[bucket];
+  entry.count++;
+  entry.digest ^= digest;
+  return true;
+}
+
+std::vector<SyncBuckets::Summary>
+SyncBuckets::getSummaries() const
+{
+  std::vector<Summary> summaries;
+  for (const auto& entry : m_buckets) {
+    summaries.push_back({entry.first, entry.second.count, entry.second.digest});
+  }
+  return summaries;
+}
+
+std::vector<uint64_t>
+SyncBuckets::findDifferentBuckets(const std::vector<Summary>& remoteSummaries,
+                                  const std::function<Summary(uint64_t)>& summarizeUntracked) const
+{
+  std::vector<uint64_t> buckets;
+  for (const auto& remote : remoteSummaries) {
+    if (remote.count == 0) continue;
+    Summary local{remote.bucket, 0, 0};
+    if (!isTracked(remote.bucket)) {
+      local = summarizeUntracked(remote.bucket);
+    }
+    else {
+      auto entry = m_buckets.find(remote.bucket);
+      if (entry != m_buckets.end()) {
+        local = {entry->first, entry->second.count, entry->second.digest};
+      }
+    }
+    if (local.count != remote.count || local.digest != remote.digest) {
+      buckets.push_back(remote.bucket);
+    }
+  }
+  return buckets;
+}
+
+}  // namespace dledger
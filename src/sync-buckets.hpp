@@ -0,0 +1,98 @@
+#ifndef DLEDGER_SRC_SYNC_BUCKETS_H_
+#define DLEDGER_SRC_SYNC_BUCKETS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace dledger {
+
+/**
+ * Summaries of the accepted records, grouped in buckets by their generation time.
+ * A bucket is summarized by its record count and the XOR of the truncated digests of its
+ * records, so two peers holding the same records in a bucket have the same summary.
+ * Peers compare the summaries to find the buckets they differ in and then exchange only the
+ * record names of those buckets, which are listed from the storage.
+ * Only the summaries of the latest buckets, the window, and of the buckets after it are kept;
+ * older buckets have to be summarized from the storage.
+ */
+class SyncBuckets
+{
+public:
+  struct Summary {
+    uint64_t bucket;
+    uint64_t count;
+    uint64_t digest;
+  };
+
+  explicit
+  SyncBuckets(size_t windowSize);
+
+  /**
+   * Move the window forward so that it ends at the bucket, dropping the summaries before it.
+   */
+  void
+  advance(uint64_t latestBucket);
+
+  /**
+   * Add a record to a bucket. Each record must be added once.
+   * The window is not moved, so that a record generated in the future does not drop the summaries.
+   * @return false if the bucket is before the window and the record is not summarized
+   */
+  bool
+  insert(uint64_t bucket, uint64_t digest);
+
+  /**
+   * @return whether the summary of the bucket is kept, i.e. the bucket is not before the window
+   */
+  bool
+  isTracked(uint64_t bucket) const
+  {
+    return bucket >= getFirstBucket();
+  }
+
+  /**
+   * @return the first bucket of the window
+   */
+  uint64_t
+  getFirstBucket() const
+  {
+    return m_latestBucket < m_windowSize ? 0 : m_latestBucket - m_windowSize + 1;
+  }
+
+  /**
+   * @return the summaries of the non-empty tracked buckets, oldest first
+   */
+  std::vector<Summary>
+  getSummaries() const;
+
+  /**
+   * @param summarizeUntracked summarizes a bucket before the window
+   * @return the buckets in which the remote summaries differ from ours
+   */
+  std::vector<uint64_t>
+  findDifferentBuckets(const std::vector<Summary>& remoteSummaries,
+                       const std::function<Summary(uint64_t)>& summarizeUntracked) const;
+
+  size_t
+  size() const
+  {
+    return m_buckets.size();
+  }
+
+private:
+  struct Bucket {
+    uint64_t count = 0;
+    uint64_t digest = 0;
+  };
+
+  size_t m_windowSize;
+  uint64_t m_latestBucket = 0;
+  std::map<uint64_t, Bucket> m_buckets;
+};
+
+}  // namespace dledger
+
+#endif  // DLEDGER_SRC_SYNC_BUCKETS_H_
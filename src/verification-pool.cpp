@@ -0,0 +1,75 @@
+#include "verification-pool.hpp"
+
+namespace dledger {
+
+VerificationPool::VerificationPool(boost::asio::io_service& ioService, size_t threadCount)
+    : m_ioService(ioService)
+{
+  for (size_t i = 0; i < threadCount; i++) {
+    m_threads.emplace_back(&VerificationPool::run, this);
+  }
+}
+
+VerificationPool::~VerificationPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isStopped = true;
+  }
+  m_condition.notify_all();
+  for (auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void
+VerificationPool::verify(const Task& task, const OnVerified& onVerified)
+{
+  if (m_threads.empty()) {
+    onVerified(runTask(task));
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.emplace_back(task, onVerified);
+  }
+  m_condition.notify_one();
+}
+
+bool
+VerificationPool::runTask(const Task& task)
+{
+  try {
+    return task();
+  }
+  catch (const std::exception& e) {
+    return false;
+  }
+}
+
+void
+VerificationPool::run()
+{
+  std::weak_ptr<bool> isAlive = m_isAlive;
+  while (true) {
+    std::pair<Task, OnVerified> item;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [this] { return m_isStopped || !m_tasks.empty(); });
+      if (m_isStopped) {
+        return;
+      }
+      item = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+    bool isValid = runTask(item.first);
+    auto onVerified = std::move(item.second);
+    m_ioService.post([isAlive, onVerified, isValid] {
+      if (!isAlive.expired()) {
+        onVerified(isValid);
+      }
+    });
+  }
+}
+
+}  // namespace dledger
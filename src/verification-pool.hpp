@@ -0,0 +1,67 @@
+#ifndef DLEDGER_SRC_VERIFICATION_POOL_H_
+#define DLEDGER_SRC_VERIFICATION_POOL_H_
+
+#include <boost/asio/io_service.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dledger {
+
+/**
+ * Runs verification tasks on worker threads and posts their results back to the io_service thread,
+ * so that the callbacks touch the ledger state from that thread only.
+ * Results whose callbacks have not run when the pool is destroyed are dropped.
+ */
+class VerificationPool
+{
+public:
+  using Task = std::function<bool()>;
+  using OnVerified = std::function<void(bool)>;
+
+  /**
+   * @param threadCount the number of worker threads; with no threads, tasks run inline in verify()
+   */
+  VerificationPool(boost::asio::io_service& ioService, size_t threadCount);
+
+  ~VerificationPool();
+
+  /**
+   * Run the task on a worker thread. A task that throws counts as failed.
+   * @param onVerified called on the io_service thread with the result of the task
+   */
+  void
+  verify(const Task& task, const OnVerified& onVerified);
+
+  size_t
+  getThreadCount() const
+  {
+    return m_threads.size();
+  }
+
+private:
+  void
+  run();
+
+  static bool
+  runTask(const Task& task);
+
+private:
+  boost::asio::io_service& m_ioService;
+  std::vector<std::thread> m_threads;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::deque<std::pair<Task, OnVerified>> m_tasks;
+  bool m_isStopped = false;
+  // expires with the pool, so that results posted but not yet delivered are dropped
+  std::shared_ptr<bool> m_isAlive = std::make_shared<bool>(true);
+};
+
+}  // namespace dledger
+
+#endif  // DLEDGER_SRC_VERIFICATION_POOL_H_
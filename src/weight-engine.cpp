@@ -0,0 +1,104 @@
+#include "weight-engine.hpp"
+
+#include <algorithm>
+
+namespace dledger {
+
+bool
+ProducerSet::insert(uint32_t index)
+{
+  uint64_t* word = &m_inlineBits;
+  if (index >= 64) {
+    size_t wordIndex = index / 64 - 1;
+    if (wordIndex >= m_overflowBits.size()) {
+      m_overflowBits.resize(wordIndex + 1, 0);
+    }
+    word = &m_overflowBits[wordIndex];
+  }
+  uint64_t mask = uint64_t(1) << (index % 64);
+  if (*word & mask) {
+    return false;
+  }
+  *word |= mask;
+  m_count++;
+  return true;
+}
+
+bool
+ProducerSet::contains(uint32_t index) const
+{
+  uint64_t mask = uint64_t(1) << (index % 64);
+  if (index < 64) {
+    return (m_inlineBits & mask) != 0;
+  }
+  size_t wordIndex = index / 64 - 1;
+  return wordIndex < m_overflowBits.size() && (m_overflowBits[wordIndex] & mask) != 0;
+}
+
+void
+WeightEngine::addRecord(NameHandle record, NameHandle producer, const std::vector<NameHandle>& pointers)
+{
+  if (record >= m_nodes.size()) {
+    m_nodes.resize(record + 1);
+  }
+  auto& node = m_nodes[record];
+  if (node.tracked) {
+    return;
+  }
+  node.tracked = true;
+  node.producer = producer;
+  for (auto pointer : pointers) {
+    if (!hasRecord(pointer)) continue;
+    node.parents.push_back(pointer);
+    m_nodes[pointer].children.push_back(record);
+  }
+  m_size++;
+}
+
+void
+WeightEngine::removeRecord(NameHandle record)
+{
+  if (!hasRecord(record)) {
+    return;
+  }
+  auto& node = m_nodes[record];
+  for (auto parent : node.parents) {
+    auto& siblings = m_nodes[parent].children;
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), record), siblings.end());
+  }
+  for (auto child : node.children) {
+    auto& parents = m_nodes[child].parents;
+    parents.erase(std::remove(parents.begin(), parents.end(), record), parents.end());
+  }
+  node = Node();
+  m_size--;
+}
+
+size_t
+WeightEngine::getWeight(NameHandle record) const
+{
+  return m_nodes[record].refSet.size();
+}
+
+std::vector<NameHandle>
+WeightEngine::propagateWeight(NameHandle record)
+{
+  std::vector<NameHandle> updated;
+  NameHandle producer = m_nodes[record].producer;
+  std::vector<NameHandle> stack{record};
+  while (!stack.empty()) {
+    NameHandle current = stack.back();
+    stack.pop_back();
+    for (auto parent : m_nodes[current].parents) {
+      auto& parentNode = m_nodes[parent];
+      if (parentNode.producer == producer) continue;
+      if (parentNode.refSet.insert(producer)) {
+        stack.push_back(parent);
+        updated.push_back(parent);
+      }
+    }
+  }
+  return updated;
+}
+
+}  // namespace dledger
@@ -0,0 +1,130 @@
+#ifndef DLEDGER_SRC_WEIGHT_ENGINE_H_
+#define DLEDGER_SRC_WEIGHT_ENGINE_H_
+
+#include "name-table.hpp"
+
+#include <vector>
+
+namespace dledger {
+
+/**
+ * A set of producers, kept as a bitset keyed by the producer index.
+ * The first 64 producers are stored inline without any allocation.
+ */
+class ProducerSet
+{
+public:
+  /**
+   * Add a producer to the set.
+   * @return true if the producer was not in the set before
+   */
+  bool
+  insert(uint32_t index);
+
+  bool
+  contains(uint32_t index) const;
+
+  size_t
+  size() const
+  {
+    return m_count;
+  }
+
+  bool
+  empty() const
+  {
+    return m_count == 0;
+  }
+
+private:
+  uint64_t m_inlineBits = 0;
+  std::vector<uint64_t> m_overflowBits;
+  size_t m_count = 0;
+};
+
+/**
+ * Weight bookkeeping of the tailing records in the DAG.
+ * Records and producers are identified by their NameTable handles. Each record keeps the handles
+ * of its tailing parents and children, so that weight propagation only walks the adjacency arrays
+ * and never touches the record itself.
+ */
+class WeightEngine
+{
+public:
+  /**
+   * Add a tailing record.
+   * Pointers to records that are not tracked (e.g., records already deep in the DAG) are ignored.
+   * @param record the handle of the record full name
+   * @param producer the handle of the producer prefix, used as the index in the producer sets
+   * @param pointers the handles of the preceding records in the record header
+   */
+  void
+  addRecord(NameHandle record, NameHandle producer, const std::vector<NameHandle>& pointers);
+
+  /**
+   * Stop tracking a record.
+   */
+  void
+  removeRecord(NameHandle record);
+
+  bool
+  hasRecord(NameHandle record) const
+  {
+    return record < m_nodes.size() && m_nodes[record].tracked;
+  }
+
+  /**
+   * @return the tailing records that the record points to
+   */
+  const std::vector<NameHandle>&
+  getParents(NameHandle record) const
+  {
+    return m_nodes[record].parents;
+  }
+
+  /**
+   * @return the tailing records that point to the record
+   */
+  const std::vector<NameHandle>&
+  getChildren(NameHandle record) const
+  {
+    return m_nodes[record].children;
+  }
+
+  /**
+   * @return the number of distinct producers that have endorsed the record
+   */
+  size_t
+  getWeight(NameHandle record) const;
+
+  /**
+   * Propagate the endorsement of the record's producer to its tailing ancestors.
+   * The walk stops at ancestors that are from the same producer (interlock) or
+   * that have already been endorsed by the producer.
+   * @return the records whose weight increased, in the order they were reached
+   */
+  std::vector<NameHandle>
+  propagateWeight(NameHandle record);
+
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+private:
+  struct Node {
+    bool tracked = false;
+    NameHandle producer;
+    std::vector<NameHandle> parents;
+    std::vector<NameHandle> children;
+    ProducerSet refSet;
+  };
+
+  std::vector<Node> m_nodes;
+  size_t m_size = 0;
+};
+
+}  // namespace dledger
+
+#endif  // DLEDGER_SRC_WEIGHT_ENGINE_H_
@@ -1,6 +1,8 @@
 #include "backend.hpp"
+#include "record_name.hpp"
 #include <ndn-cxx/name.hpp>
 #include <iostream>
+#include <cassert>
 #include <ndn-cxx/security/signature-sha256-with-rsa.hpp>
 
 using namespace dledger;
@@ -67,6 +69,129 @@ testBackEndList() {
     return true;
 }
 
+bool
+testBackEndBatch()
+{
+  {
+    Backend backend("/tmp/test-Batch.leveldb", 4);
+    for (const auto &name : backend.listRecord("")) {
+        backend.deleteRecord(name);
+    }
+    backend.flush();
+    backend.putRecord(makeData("/dledger/a/1", "content is 1"));
+    auto data = makeData("/dledger/a/2", "content is 2");
+    backend.putRecord(data);
+    backend.putRecord(makeData("/dledger/b/1", "content is 3"));
+    // pending writes are visible before the flush
+    assert(backend.hasPendingWrites());
+    assert(backend.getRecord(data->getFullName()) != nullptr);
+    assert(backend.listRecord(Name("/dledger/a")).size() == 2);
+    backend.deleteRecord(data->getFullName());
+    assert(!backend.hasPendingWrites());
+    assert(backend.getRecord(data->getFullName()) == nullptr);
+    backend.putRecord(data);
+  }
+  // the destructor commits the rest
+  Backend backend("/tmp/test-Batch.leveldb", 4);
+  return backend.listRecord(Name("/dledger")).size() == 3 && !backend.hasPendingWrites();
+}
+
+bool
+testBackEndLogEngine()
+{
+  {
+    Backend backend("/tmp/test-Log.db", 1, "log");
+    for (const auto &name : backend.listRecord("")) {
+        backend.deleteRecord(name);
+    }
+    for (int i = 0; i < 10; i++) {
+        backend.putRecord(makeData("/dledger/a/" + std::to_string(i), "content is " + std::to_string(i)));
+        backend.putRecord(makeData("/dledger/b/" + std::to_string(i), "content is " + std::to_string(i)));
+    }
+  }
+  Backend backend("/tmp/test-Log.db", 1, "log");
+  auto data = makeData("/dledger/a/5", "content is 5");
+  auto anotherRecord = backend.getRecord(data->getFullName());
+  return anotherRecord != nullptr && data->wireEncode() == anotherRecord->wireEncode() &&
+         backend.listRecord(Name("/dledger/a")).size() == 10 && backend.listRecord(Name("/dledger")).size() == 20;
+}
+
+bool
+testBackEndPaging()
+{
+  Backend backend("/tmp/test-Paging.leveldb", 8);
+  for (const auto &name : backend.listRecord("")) {
+      backend.deleteRecord(name);
+  }
+  backend.flush();
+  for (int i = 0; i < 10; i++) {
+    backend.putRecord(makeData("/dledger/a/" + std::to_string(i), "content is " + std::to_string(i)));
+    backend.putRecord(makeData("/dledger/b/" + std::to_string(i), "content is " + std::to_string(i)));
+  }
+  // some of the writes are still pending, including a deletion
+  backend.putRecord(makeData("/dledger/a/10", "content is 10"));
+  backend.deleteRecord(makeData("/dledger/a/3", "content is 3")->getFullName());
+  assert(backend.hasPendingWrites());
+
+  std::list<Name> names;
+  std::string cursor;
+  size_t pageCount = 0;
+  do {
+    auto page = backend.listRecord(Name("/dledger/a"), 3, cursor);
+    assert(page.size() <= 3);
+    names.splice(names.end(), page);
+    pageCount++;
+  } while (!cursor.empty());
+  assert(pageCount == 4);
+  return names == backend.listRecord(Name("/dledger/a")) && names.size() == 10;
+}
+
+bool
+testBackEndIndex()
+{
+  using namespace ndn;
+  Backend backend("/tmp/test-Index.leveldb");
+  for (const auto &name : backend.listRecord("")) {
+      backend.deleteRecord(name);
+  }
+  auto start = time::fromUnixTimestamp(time::milliseconds(1600000000000));
+  for (int i = 0; i < 10; i++) {
+    auto timestamp = start + time::seconds(i);
+    RecordName generic(Name(i % 2 ? "/dledger/a" : "/dledger/ab"), RecordType::GENERIC_RECORD,
+                       std::to_string(i), timestamp);
+    backend.putRecord(makeData(generic.toUri(), "content is " + std::to_string(i)));
+    RecordName cert(Name("/dledger/b"), RecordType::CERTIFICATE_RECORD, std::to_string(i), timestamp);
+    backend.putRecord(makeData(cert.toUri(), "content is " + std::to_string(i)));
+  }
+  // names that are not record names are not indexed
+  backend.putRecord(makeData("/dledger/12345", "content is 12345"));
+
+  assert(backend.listRecord(Name()).size() == 21);
+  assert(backend.listRecordByTime(start, time::system_clock::TimePoint::max()).size() == 20);
+  auto byTime = backend.listRecordByTime(start + time::seconds(2), start + time::seconds(4));
+  assert(byTime.size() == 4);
+  assert(RecordName(byTime.front()).getGenerationTimestamp() == start + time::seconds(2));
+  std::list<Name> pagedByTime;
+  std::string cursor;
+  do {
+    auto page = backend.listRecordByTime(start + time::seconds(2), start + time::seconds(9), 3, cursor);
+    assert(page.size() <= 3);
+    pagedByTime.splice(pagedByTime.end(), page);
+  } while (!cursor.empty());
+  assert(pagedByTime == backend.listRecordByTime(start + time::seconds(2), start + time::seconds(9)));
+  assert(backend.listRecordByType(RecordType::CERTIFICATE_RECORD, start, start + time::seconds(5)).size() == 5);
+  assert(backend.listRecordByType(RecordType::REVOCATION_RECORD, start, time::system_clock::TimePoint::max()).empty());
+  // /dledger/a is a prefix of /dledger/ab but a different producer
+  auto byProducer = backend.listRecordByProducer(Name("/dledger/a"), start, time::system_clock::TimePoint::max());
+  assert(byProducer.size() == 5);
+  for (const auto& name : byProducer) {
+    assert(RecordName(name).getProducerPrefix() == Name("/dledger/a"));
+  }
+  backend.deleteRecord(byProducer.front());
+  return backend.listRecordByProducer(Name("/dledger/a"), start, time::system_clock::TimePoint::max()).size() == 4 &&
+         backend.listRecordByTime(start, time::system_clock::TimePoint::max()).size() == 19;
+}
+
 bool
 testNameGet()
 {
@@ -95,6 +220,34 @@ main(int argc, char** argv)
   else {
     std::cout << "testBackEndList with no errors" << std::endl;
   }
+  success = testBackEndBatch();
+  if (!success) {
+    std::cout << "testBackEndBatch failed" << std::endl;
+  }
+  else {
+    std::cout << "testBackEndBatch with no errors" << std::endl;
+  }
+  success = testBackEndLogEngine();
+  if (!success) {
+    std::cout << "testBackEndLogEngine failed" << std::endl;
+  }
+  else {
+    std::cout << "testBackEndLogEngine with no errors" << std::endl;
+  }
+  success = testBackEndPaging();
+  if (!success) {
+    std::cout << "testBackEndPaging failed" << std::endl;
+  }
+  else {
+    std::cout << "testBackEndPaging with no errors" << std::endl;
+  }
+  success = testBackEndIndex();
+  if (!success) {
+    std::cout << "testBackEndIndex failed" << std::endl;
+  }
+  else {
+    std::cout << "testBackEndIndex with no errors" << std::endl;
+  }
   success = testNameGet();
   if (!success) {
     std::cout << "testNameGet failed" << std::endl;
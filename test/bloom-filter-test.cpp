@@ -0,0 +1,65 @@
+#include "bloom-filter.hpp"
+#include <functional>
+#include <iostream>
+#include <cassert>
+#include <string>
+
+using namespace dledger;
+
+uint64_t
+hashOf(const std::string& key)
+{
+  return std::hash<std::string>()(key);
+}
+
+bool
+testNoFalseNegatives()
+{
+  BloomFilter filter(1000);
+  for (int i = 0; i < 1000; i++) {
+    filter.insert(hashOf("/dledger/a/" + std::to_string(i)));
+  }
+  for (int i = 0; i < 1000; i++) {
+    if (!filter.mayContain(hashOf("/dledger/a/" + std::to_string(i)))) {
+      return false;
+    }
+  }
+  return filter.size() == 1000 && filter.getCapacity() == 1000;
+}
+
+bool
+testFalsePositiveRate()
+{
+  BloomFilter filter(10000);
+  for (int i = 0; i < 10000; i++) {
+    filter.insert(hashOf("/dledger/a/" + std::to_string(i)));
+  }
+  int falsePositives = 0;
+  for (int i = 0; i < 10000; i++) {
+    if (filter.mayContain(hashOf("/dledger/b/" + std::to_string(i)))) {
+      falsePositives++;
+    }
+  }
+  // about 1% with 10 bits per entry
+  return falsePositives < 300;
+}
+
+int
+main(int argc, char** argv)
+{
+  auto success = testNoFalseNegatives();
+  if (!success) {
+    std::cout << "testNoFalseNegatives failed" << std::endl;
+  }
+  else {
+    std::cout << "testNoFalseNegatives with no errors" << std::endl;
+  }
+  success = testFalsePositiveRate();
+  if (!success) {
+    std::cout << "testFalsePositiveRate failed" << std::endl;
+  }
+  else {
+    std::cout << "testFalsePositiveRate with no errors" << std::endl;
+  }
+  return 0;
+}
@@ -32,7 +32,7 @@ void periodicAddRecord(shared_ptr<Ledger> ledger, Scheduler& scheduler) {
 }
 
 std::string getNodeDigest(const Record &r) {
-    auto hash = r.m_data->getFullName().get(-1).toUri();
+    auto hash = r.getData()->getFullName().get(-1).toUri();
     hash = hash.substr(hash.size() - 5);
     return "\"" + readString(r.getProducerPrefix().get(-1)) + '/' + hash + "\"";
 }
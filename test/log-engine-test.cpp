@@ -0,0 +1,161 @@
+#include "log-engine.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <unistd.h>
+
+using namespace dledger;
+
+const std::string DB_DIR = "/tmp/test-log-engine";
+
+void
+clearLog()
+{
+  for (int segment = 0; std::remove((DB_DIR + "/" + std::to_string(segment) + ".log").c_str()) == 0; segment++) {
+  }
+}
+
+StorageEngine::Write
+makeWrite(const std::string& key, const std::string& value)
+{
+  return {key, reinterpret_cast<const uint8_t*>(value.data()), value.size()};
+}
+
+bool
+hasValue(const LogEngine& engine, const std::string& key, const std::string& value)
+{
+  auto buffer = engine.get(key);
+  return buffer != nullptr && std::string(buffer->begin(), buffer->end()) == value;
+}
+
+bool
+testLogEngine()
+{
+  clearLog();
+  std::string value1 = "content is 1";
+  std::string value2 = "content is 2";
+  {
+    LogEngine engine(DB_DIR);
+    if (!engine.write({makeWrite("a/1", value1), makeWrite("a/2", value2), makeWrite("b/1", value1)})) return false;
+    if (!engine.write({{"b/1", nullptr, 0}})) return false;
+    assert(hasValue(engine, "a/2", value2) && engine.get("b/1") == nullptr);
+    assert(engine.listKeys("a/", "a0") == std::vector<std::string>({"a/1", "a/2"}));
+    assert(engine.listKeys("a/", "", 1) == std::vector<std::string>({"a/1"}));
+  }
+  // the index is rebuilt from the log
+  LogEngine engine(DB_DIR);
+  return hasValue(engine, "a/1", value1) && hasValue(engine, "a/2", value2) &&
+         engine.get("b/1") == nullptr && engine.listKeys("", "").size() == 2;
+}
+
+bool
+testTornTail()
+{
+  clearLog();
+  std::string value = "content";
+  {
+    LogEngine engine(DB_DIR);
+    if (!engine.write({makeWrite("a/1", value)})) return false;
+    if (!engine.write({makeWrite("a/2", value)})) return false;
+  }
+  // corrupt the last byte of the last entry and append a partial header
+  {
+    std::fstream log(DB_DIR + "/0.log", std::ios::in | std::ios::out | std::ios::binary);
+    log.seekp(-1, std::ios::end);
+    log.put('X');
+    log.seekp(0, std::ios::end);
+    log.write("\x01\x02", 2);
+  }
+  {
+    LogEngine engine(DB_DIR);
+    assert(hasValue(engine, "a/1", value) && engine.get("a/2") == nullptr);
+    // appends continue right after the last valid entry
+    if (!engine.write({makeWrite("a/3", value)})) return false;
+  }
+  LogEngine engine(DB_DIR);
+  return hasValue(engine, "a/3", value) && engine.listKeys("a/", "a0").size() == 2;
+}
+
+bool
+testTornBatch()
+{
+  clearLog();
+  std::string value = "content";
+  size_t firstBatchSize = 0;
+  {
+    LogEngine engine(DB_DIR);
+    if (!engine.write({makeWrite("a/1", value), makeWrite("a/2", value)})) return false;
+    firstBatchSize = std::ifstream(DB_DIR + "/0.log", std::ios::binary | std::ios::ate).tellg();
+    if (!engine.write({makeWrite("b/1", value), {"a/1", nullptr, 0}, makeWrite("b/2", value)})) return false;
+  }
+  // cut the second batch after its first two entries, which are complete and valid
+  size_t entrySize = 3 * sizeof(uint32_t) + 3 + value.size(); // header, 3-byte key and value
+  if (::truncate((DB_DIR + "/0.log").c_str(), firstBatchSize + entrySize * 2) != 0) return false;
+  {
+    LogEngine engine(DB_DIR);
+    // none of the second batch is applied
+    assert(hasValue(engine, "a/1", value) && hasValue(engine, "a/2", value));
+    assert(engine.get("b/1") == nullptr && engine.get("b/2") == nullptr);
+    if (!engine.write({makeWrite("b/3", value)})) return false;
+  }
+  LogEngine engine(DB_DIR);
+  return hasValue(engine, "a/1", value) && hasValue(engine, "b/3", value) && engine.listKeys("", "").size() == 3;
+}
+
+bool
+testSegments()
+{
+  clearLog();
+  std::string value(100, 'x');
+  {
+    LogEngine engine(DB_DIR, 256);
+    for (int i = 0; i < 10; i++) {
+      if (!engine.write({makeWrite("k/" + std::to_string(i), value)})) return false;
+    }
+    assert(engine.getSegmentCount() > 1);
+  }
+  LogEngine engine(DB_DIR, 256);
+  for (int i = 0; i < 10; i++) {
+    if (!hasValue(engine, "k/" + std::to_string(i), value)) {
+      return false;
+    }
+  }
+  return engine.getSegmentCount() > 1;
+}
+
+int
+main(int argc, char** argv)
+{
+  auto success = testLogEngine();
+  if (!success) {
+    std::cout << "testLogEngine failed" << std::endl;
+  }
+  else {
+    std::cout << "testLogEngine with no errors" << std::endl;
+  }
+  success = testTornTail();
+  if (!success) {
+    std::cout << "testTornTail failed" << std::endl;
+  }
+  else {
+    std::cout << "testTornTail with no errors" << std::endl;
+  }
+  success = testTornBatch();
+  if (!success) {
+    std::cout << "testTornBatch failed" << std::endl;
+  }
+  else {
+    std::cout << "testTornBatch with no errors" << std::endl;
+  }
+  success = testSegments();
+  if (!success) {
+    std::cout << "testSegments failed" << std::endl;
+  }
+  else {
+    std::cout << "testSegments with no errors" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,60 @@
+#include "lru-cache.hpp"
+#include <iostream>
+#include <cassert>
+
+using namespace dledger;
+
+bool
+testEviction()
+{
+  LruCache<int> cache(2);
+  cache.insert(Name("/a/1"), 1);
+  cache.insert(Name("/a/2"), 2);
+  // touching /a/1 makes /a/2 the least recently used
+  auto touched = cache.find(Name("/a/1"));
+  assert(touched != nullptr);
+  cache.insert(Name("/a/3"), 3);
+  assert(cache.find(Name("/a/2")) == nullptr);
+  assert(*cache.find(Name("/a/1")) == 1 && *cache.find(Name("/a/3")) == 3);
+  cache.insert(Name("/a/3"), 4);
+  assert(*cache.find(Name("/a/3")) == 4 && cache.size() == 2);
+  cache.erase(Name("/a/1"));
+  assert(cache.find(Name("/a/1")) == nullptr && cache.size() == 1);
+  cache.insert(Name("/b/1"), 5);
+  cache.erasePrefix(Name("/a"));
+  return cache.find(Name("/a/3")) == nullptr && *cache.find(Name("/b/1")) == 5 && cache.size() == 1;
+}
+
+bool
+testHitCounters()
+{
+  LruCache<int> cache(4);
+  cache.insert(Name("/a/1"), 1);
+  cache.find(Name("/a/1"));
+  cache.find(Name("/a/1"));
+  cache.find(Name("/a/2"));
+  // a cache holds at least one entry
+  LruCache<int> tiny(0);
+  int inserted = tiny.insert(Name("/a/1"), 1);
+  return inserted == 1 && cache.getHitCount() == 2 && cache.getMissCount() == 1 && tiny.find(Name("/a/1")) != nullptr;
+}
+
+int
+main(int argc, char** argv)
+{
+  auto success = testEviction();
+  if (!success) {
+    std::cout << "testEviction failed" << std::endl;
+  }
+  else {
+    std::cout << "testEviction with no errors" << std::endl;
+  }
+  success = testHitCounters();
+  if (!success) {
+    std::cout << "testHitCounters failed" << std::endl;
+  }
+  else {
+    std::cout << "testHitCounters with no errors" << std::endl;
+  }
+  return 0;
+}
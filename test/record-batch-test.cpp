@@ -0,0 +1,106 @@
+#include "record-batch.hpp"
+#include <iostream>
+#include <cassert>
+#include <ndn-cxx/encoding/buffer.hpp>
+
+using namespace dledger;
+
+std::shared_ptr<ndn::Data>
+makeData(const std::string& name, const std::string& content)
+{
+  auto data = make_shared<Data>(ndn::Name(name));
+  data->setContent((const uint8_t*)content.c_str(), content.size());
+  SignatureInfo fakeSignature;
+  ConstBufferPtr empty = make_shared<Buffer>();
+  fakeSignature.setSignatureType(tlv::SignatureSha256WithRsa);
+  data->setSignatureInfo(fakeSignature);
+  data->setSignatureValue(empty);
+  data->wireEncode();
+  return data;
+}
+
+bool
+testRequestName()
+{
+  Name producer("/dledger/a");
+  auto record = makeData("/dledger/a/Generic/x/1", "x");
+  Name recordName = record->getFullName();
+  // the requester names the batch and the producer parses the Interest carrying the name
+  Name interestName = RecordBatch::makeRequestName(producer, 16, recordName);
+  Name parsedRecordName;
+  size_t depth = 0;
+  Name requestName = RecordBatch::parseRequestName(interestName, producer.size(), parsedRecordName, depth);
+  assert(requestName == interestName && parsedRecordName == recordName && depth == 16);
+
+  // the names of the segments carry the same request name
+  Name segmentName = Name(interestName).appendVersion().appendSegment(3);
+  requestName = RecordBatch::parseRequestName(segmentName, producer.size(), parsedRecordName, depth);
+  assert(requestName == interestName && parsedRecordName == recordName);
+
+  try {
+    RecordBatch::parseRequestName(Name(producer).append("BATCH").appendNumber(16).append("x"),
+                                  producer.size(), parsedRecordName, depth);
+    return false;
+  }
+  catch (const std::exception&) {
+  }
+  return true;
+}
+
+bool
+testRoundTrip()
+{
+  std::vector<std::shared_ptr<ndn::Data>> records;
+  std::vector<Block> wires;
+  for (int i = 0; i < 20; i++) {
+    records.push_back(makeData("/dledger/a/Generic/" + std::to_string(i) + "/1", std::string(100, 'a' + i)));
+    wires.push_back(records.back()->wireEncode());
+  }
+  Name requestName = RecordBatch::makeRequestName(Name("/dledger/a"), 16, records.front()->getFullName());
+  auto segments = RecordBatch::makeSegments(requestName, wires, 500);
+  assert(segments.size() > 1);
+
+  // reassemble the segments as the segment fetcher does
+  auto content = make_shared<Buffer>();
+  for (const auto& segment : segments) {
+    assert(requestName.isPrefixOf(segment->getName()));
+    const auto& value = segment->getContent();
+    content->insert(content->end(), value.value_begin(), value.value_end());
+  }
+  auto parsed = RecordBatch::parse(content);
+  if (parsed.size() != records.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < records.size(); i++) {
+    if (parsed[i]->wireEncode() != records[i]->wireEncode()) {
+      return false;
+    }
+  }
+  // a record without ancestors to reply still gets a segment, carrying an empty batch
+  auto emptySegments = RecordBatch::makeSegments(requestName, {}, 500);
+  if (emptySegments.size() != 1) {
+    return false;
+  }
+  const auto& emptyValue = emptySegments.front()->getContent();
+  return RecordBatch::parse(make_shared<Buffer>(emptyValue.value(), emptyValue.value_size())).empty();
+}
+
+int
+main(int argc, char** argv)
+{
+  auto success = testRequestName();
+  if (!success) {
+    std::cout << "testRequestName failed" << std::endl;
+  }
+  else {
+    std::cout << "testRequestName with no errors" << std::endl;
+  }
+  success = testRoundTrip();
+  if (!success) {
+    std::cout << "testRoundTrip failed" << std::endl;
+  }
+  else {
+    std::cout << "testRoundTrip with no errors" << std::endl;
+  }
+  return 0;
+}
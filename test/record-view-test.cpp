@@ -0,0 +1,91 @@
+#include "record-view.hpp"
+#include "record_name.hpp"
+#include <iostream>
+#include <cassert>
+#include <ndn-cxx/security/signature-sha256-with-rsa.hpp>
+
+using namespace dledger;
+
+std::shared_ptr<const ndn::Data>
+makeRecordData(Record& record, const Name& producer)
+{
+  auto data = make_shared<Data>(RecordName(producer, record.getType(), record.getUniqueIdentifier()));
+  data->setContent(record.wireEncode());
+  ndn::SignatureSha256WithRsa fakeSignature;
+  fakeSignature.setValue(ndn::encoding::makeEmptyBlock(tlv::SignatureValue));
+  data->setSignature(fakeSignature);
+  data->wireEncode();
+  return data;
+}
+
+bool
+testGenericRecordView()
+{
+  GenericRecord record("record-1");
+  record.addPointer(Name(RecordName(Name("/dledger/b"), GENERIC_RECORD, "0")));
+  record.addPointer(Name(RecordName(Name("/dledger/c"), GENERIC_RECORD, "0")));
+  record.addRecordItem(makeStringBlock(tlv::Content, "payload"));
+  auto data = makeRecordData(record, Name("/dledger/a"));
+
+  RecordView view(data);
+  assert(view.getRecordName() == data->getFullName());
+  assert(view.getType() == GENERIC_RECORD && view.getProducerPrefix() == Name("/dledger/a"));
+  assert(view.getPointers().size() == 2 && view.getRecord().getRecordItems().size() == 1);
+  assert(view.getPrevCertificates().empty());
+  // copies share the parsed record
+  RecordView copy = view;
+  return &copy.getRecord() == &view.getRecord() && &copy.getData() == data.get();
+}
+
+bool
+testCertificateRecordView()
+{
+  CertificateRecord record("cert-1");
+  auto prevCert = Name(RecordName(Name("/dledger/a"), CERTIFICATE_RECORD, "cert-0"));
+  record.addPrevCertPointer(prevCert);
+  auto data = makeRecordData(record, Name("/dledger/a"));
+  RecordView view(data);
+  return view.getType() == CERTIFICATE_RECORD && view.getPrevCertificates().size() == 1 &&
+         view.getPrevCertificates().front() == prevCert;
+}
+
+bool
+testMalformedRecordView()
+{
+  auto data = make_shared<Data>(Name("/dledger/12345"));
+  data->setContent(makeStringBlock(tlv::Content, "not a record"));
+  try {
+    RecordView view(data);
+  }
+  catch (const std::exception& e) {
+    return true;
+  }
+  return false;
+}
+
+int
+main(int argc, char** argv)
+{
+  auto success = testGenericRecordView();
+  if (!success) {
+    std::cout << "testGenericRecordView failed" << std::endl;
+  }
+  else {
+    std::cout << "testGenericRecordView with no errors" << std::endl;
+  }
+  success = testCertificateRecordView();
+  if (!success) {
+    std::cout << "testCertificateRecordView failed" << std::endl;
+  }
+  else {
+    std::cout << "testCertificateRecordView with no errors" << std::endl;
+  }
+  success = testMalformedRecordView();
+  if (!success) {
+    std::cout << "testMalformedRecordView failed" << std::endl;
+  }
+  else {
+    std::cout << "testMalformedRecordView with no errors" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,79 @@
+#include "sync-buckets.hpp"
+#include <iostream>
+#include <cassert>
+
+using namespace dledger;
+
+bool
+testBucketSummaries()
+{
+  SyncBuckets buckets(3);
+  bool inserted = buckets.insert(1, 0x11);
+  inserted = buckets.insert(1, 0x22) && inserted;
+  inserted = buckets.insert(3, 0x33) && inserted;
+  assert(inserted);
+
+  auto summaries = buckets.getSummaries();
+  assert(summaries.size() == 2);
+  assert(summaries[0].bucket == 1 && summaries[0].count == 2 && summaries[0].digest == (0x11 ^ 0x22));
+  assert(summaries[1].bucket == 3 && summaries[1].count == 1);
+
+  // the window moves forward and drops the older summaries
+  buckets.advance(4);
+  inserted = buckets.insert(4, 0x44);
+  assert(inserted);
+  bool insertedBeforeWindow = buckets.insert(1, 0x55);
+  assert(!insertedBeforeWindow);
+  // a record generated in the future does not move the window
+  inserted = buckets.insert(100, 0x66);
+  assert(inserted);
+  return !buckets.isTracked(1) && buckets.isTracked(2) && buckets.getFirstBucket() == 2 && buckets.size() == 3;
+}
+
+bool
+testFindDifferentBuckets()
+{
+  SyncBuckets local(4);
+  SyncBuckets remote(4);
+  for (auto* buckets : {&local, &remote}) {
+    buckets->insert(1, 0x11);
+    buckets->insert(2, 0x22);
+  }
+  // same count, different records
+  local.insert(3, 0x33);
+  remote.insert(3, 0x44);
+  // missing locally
+  remote.insert(4, 0x55);
+  // missing remotely: nothing to fetch
+  local.insert(5, 0x66);
+  local.advance(5);
+  remote.advance(4);
+
+  // bucket 1 is now before the local window and summarized by the caller
+  std::vector<uint64_t> summarized;
+  auto different = local.findDifferentBuckets(remote.getSummaries(), [&] (uint64_t bucket) {
+    summarized.push_back(bucket);
+    return SyncBuckets::Summary{bucket, 1, 0x11};
+  });
+  return different == std::vector<uint64_t>{3, 4} && summarized == std::vector<uint64_t>{1};
+}
+
+int
+main(int argc, char** argv)
+{
+  auto success = testBucketSummaries();
+  if (!success) {
+    std::cout << "testBucketSummaries failed" << std::endl;
+  }
+  else {
+    std::cout << "testBucketSummaries with no errors" << std::endl;
+  }
+  success = testFindDifferentBuckets();
+  if (!success) {
+    std::cout << "testFindDifferentBuckets failed" << std::endl;
+  }
+  else {
+    std::cout << "testFindDifferentBuckets with no errors" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include "verification-pool.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+
+using namespace dledger;
+
+bool
+testInline()
+{
+  boost::asio::io_service ioService;
+  VerificationPool pool(ioService, 0);
+  int result = -1;
+  pool.verify([] { return true; }, [&] (bool isValid) { result = isValid; });
+  assert(result == 1);
+  pool.verify([] () -> bool { throw std::runtime_error("bad record"); }, [&] (bool isValid) { result = isValid; });
+  return result == 0 && pool.getThreadCount() == 0;
+}
+
+bool
+testWorkers()
+{
+  boost::asio::io_service ioService;
+  // keeps run_one() waiting for the results instead of returning when no handler is ready yet
+  boost::asio::io_service::work work(ioService);
+  VerificationPool pool(ioService, 4);
+  std::atomic<size_t> runCount(0);
+  auto ioThread = std::this_thread::get_id();
+  size_t validCount = 0;
+  size_t doneCount = 0;
+  for (int i = 0; i < 100; i++) {
+    pool.verify([&runCount, i] { runCount++; return i % 2 == 0; },
+                [&] (bool isValid) {
+                  // results come back on the io_service thread
+                  assert(std::this_thread::get_id() == ioThread);
+                  validCount += isValid;
+                  doneCount++;
+                });
+  }
+  while (doneCount < 100) {
+    ioService.run_one();
+  }
+  return runCount == 100 && validCount == 50;
+}
+
+bool
+testDroppedResults()
+{
+  boost::asio::io_service ioService;
+  bool isCalled = false;
+  {
+    VerificationPool pool(ioService, 1);
+    std::atomic<bool> isRun(false);
+    pool.verify([&isRun] { isRun = true; return true; }, [&] (bool) { isCalled = true; });
+    while (!isRun) {
+      std::this_thread::yield();
+    }
+  }
+  // the pool is gone before the result is delivered
+  ioService.run();
+  return !isCalled;
+}
+
+int
+main(int argc, char** argv)
+{
+  auto success = testInline();
+  if (!success) {
+    std::cout << "testInline failed" << std::endl;
+  }
+  else {
+    std::cout << "testInline with no errors" << std::endl;
+  }
+  success = testWorkers();
+  if (!success) {
+    std::cout << "testWorkers failed" << std::endl;
+  }
+  else {
+    std::cout << "testWorkers with no errors" << std::endl;
+  }
+  success = testDroppedResults();
+  if (!success) {
+    std::cout << "testDroppedResults failed" << std::endl;
+  }
+  else {
+    std::cout << "testDroppedResults with no errors" << std::endl;
+  }
+  return 0;
+}
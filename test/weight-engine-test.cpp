@@ -0,0 +1,106 @@
+#include "name-table.hpp"
+#include "weight-engine.hpp"
+#include <iostream>
+#include <cassert>
+
+using namespace dledger;
+
+bool
+testProducerSet()
+{
+  ProducerSet set;
+  bool isInserted = set.insert(3);
+  bool isReinserted = set.insert(3);
+  bool isOtherInserted = set.insert(200);
+  assert(isInserted && !isReinserted && isOtherInserted);
+  assert(set.contains(3) && set.contains(200) && !set.contains(4));
+  return isInserted && !isReinserted && isOtherInserted && set.size() == 2;
+}
+
+bool
+testNameTable()
+{
+  NameTable table;
+  auto a = table.acquire(Name("/a/1"));
+  auto acquiredAgain = table.acquire(Name("/a/1"));
+  assert(acquiredAgain == a);
+  auto b = table.acquire(Name("/b/1"));
+  assert(a != b && table.find(Name("/b/1")) == b && table.getName(b) == Name("/b/1"));
+  table.release(a);
+  assert(table.find(Name("/a/1")) == a);
+  table.release(a);
+  assert(table.find(Name("/a/1")) == NameTable::INVALID_HANDLE);
+  // released handles are recycled
+  return acquiredAgain == a && table.acquire(Name("/c/1")) == a && table.size() == 2;
+}
+
+bool
+testWeightPropagation()
+{
+  NameTable records;
+  NameTable producers;
+  auto genesis = producers.acquire(Name("/genesis"));
+  auto a = producers.acquire(Name("/a"));
+  auto b = producers.acquire(Name("/b"));
+  auto c = producers.acquire(Name("/c"));
+
+  WeightEngine engine;
+  auto g1 = records.acquire(Name("/genesis/1"));
+  auto g2 = records.acquire(Name("/genesis/2"));
+  engine.addRecord(g1, genesis, {});
+  engine.addRecord(g2, genesis, {});
+  auto a1 = records.acquire(Name("/a/1"));
+  engine.addRecord(a1, a, {g1, g2});
+  auto updatedByA1 = engine.propagateWeight(a1);
+  assert(updatedByA1.size() == 2);
+  auto b1 = records.acquire(Name("/b/1"));
+  engine.addRecord(b1, b, {a1, g2});
+  auto updated = engine.propagateWeight(b1);
+  assert(updated.size() == 3);
+  assert(engine.getWeight(a1) == 1 && engine.getWeight(g1) == 2 && engine.getWeight(g2) == 2);
+
+  // interlock: a record from /a does not add weight to other /a records
+  auto a2 = records.acquire(Name("/a/2"));
+  engine.addRecord(a2, a, {b1, a1});
+  engine.propagateWeight(a2);
+  assert(engine.getWeight(a1) == 1 && engine.getWeight(b1) == 1);
+
+  // removed records are unlinked from their children
+  engine.removeRecord(g1);
+  records.release(g1);
+  assert(!engine.hasRecord(g1));
+  assert(engine.getParents(a1).size() == 1 && engine.getParents(a1).front() == g2);
+  assert(engine.getChildren(a1).size() == 2 && engine.getChildren(g2).size() == 2);
+  auto c1 = records.acquire(Name("/c/1"));
+  assert(c1 == g1);
+  engine.addRecord(c1, c, {a2, b1});
+  engine.propagateWeight(c1);
+  return updatedByA1.size() == 2 && engine.getWeight(a1) == 2 && engine.getWeight(g2) == 3 && engine.size() == 5;
+}
+
+int
+main(int argc, char** argv)
+{
+  auto success = testProducerSet();
+  if (!success) {
+    std::cout << "testProducerSet failed" << std::endl;
+  }
+  else {
+    std::cout << "testProducerSet with no errors" << std::endl;
+  }
+  success = testNameTable();
+  if (!success) {
+    std::cout << "testNameTable failed" << std::endl;
+  }
+  else {
+    std::cout << "testNameTable with no errors" << std::endl;
+  }
+  success = testWeightPropagation();
+  if (!success) {
+    std::cout << "testWeightPropagation failed" << std::endl;
+  }
+  else {
+    std::cout << "testWeightPropagation with no errors" << std::endl;
+  }
+  return 0;
+}